@@ -0,0 +1,196 @@
+#ifndef ASCII_CODEC_H
+#define ASCII_CODEC_H
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include "imageView.h"
+
+// Conversión entre el texto de los cuerpos P2/P3 y las muestras de una o
+// varias vistas (un canal cada una), compartida por la carga y el guardado
+// completos (image.cpp) y por la lectura/escritura fila a fila (imageStream)
+
+// Destino de las muestras ASCII en el orden del archivo: canal, columna, fila
+template<typename T>
+struct asciiSampleWriter {
+    const imageView* channels;
+    int channelCount;
+    T* rows[3];
+    size_t offset;  // Posición de la columna x dentro de la fila (x * step)
+    int c, x, y;
+
+    // Empieza en la muestra firstSample (en orden de archivo) de la imagen
+    asciiSampleWriter(const imageView* views, int count, size_t firstSample)
+        : channels(views), channelCount(count) {
+        size_t pixel = firstSample / channelCount;
+        c = static_cast<int>(firstSample % channelCount);
+        x = static_cast<int>(pixel % channels[0].width);
+        y = static_cast<int>(pixel / channels[0].width);
+        offset = static_cast<size_t>(x) * channels[0].step;
+        for (int k = 0; k < channelCount; k++) rows[k] = channels[k].row<T>(y);
+    }
+
+    void put(int value) {
+        rows[c][offset] = static_cast<T>(value);
+        if (++c < channelCount) return;
+        c = 0;
+        offset += channels[0].step;
+        if (++x < channels[0].width) return;
+        x = 0;
+        offset = 0;
+        if (++y == channels[0].height) return;
+        for (int k = 0; k < channelCount; k++) rows[k] = channels[k].row<T>(y);
+    }
+};
+
+inline bool isAsciiSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Primer error encontrado al analizar el texto; position es el byte del archivo
+struct asciiError {
+    enum kind { NONE, OUT_OF_RANGE, BAD_CHARACTER };
+    kind type;
+    size_t position;
+    int value;  // Valor fuera de rango o carácter inesperado
+
+    asciiError() : type(NONE), position(0), value(0) {}
+
+    void report() const {
+        if (type == OUT_OF_RANGE) {
+            std::cerr << "Error: Valor de píxel fuera de rango: " << value
+                      << " (byte " << position << ")" << std::endl;
+        } else if (type == BAD_CHARACTER) {
+            std::cerr << "Error: Carácter inesperado entre los píxeles: '" << static_cast<char>(value)
+                      << "' (byte " << position << ")" << std::endl;
+        }
+    }
+};
+
+// Conversión de texto a muestras sin operator>>: los dígitos se acumulan a
+// mano. Un número puede quedar partido entre dos llamadas a feed (bloques
+// consecutivos), por eso value e inNumber forman parte del estado
+template<typename T>
+struct asciiParser {
+    asciiSampleWriter<T> writer;
+    int maxValue;
+    size_t remaining;  // Muestras que faltan por guardar
+    int value;
+    bool inNumber;
+    asciiError error;
+
+    asciiParser(const imageView* channels, int channelCount, int maxValue, size_t firstSample, size_t samples)
+        : writer(channels, channelCount, firstSample), maxValue(maxValue), remaining(samples),
+          value(0), inNumber(false) {}
+
+    bool isComplete() const { return remaining == 0; }
+    bool failed() const { return error.type != asciiError::NONE; }
+
+    // Analiza [begin, end), que empieza en el byte position del archivo. Se
+    // detiene ante un error o cuando ya se guardaron todas las muestras;
+    // devuelve el primer carácter no consumido
+    const char* feed(const char* begin, const char* end, size_t position) {
+        for (const char* p = begin; p < end; p++) {
+            unsigned digit = static_cast<unsigned char>(*p) - '0';
+            if (digit < 10) {
+                value = value * 10 + static_cast<int>(digit);
+                if (value > maxValue) {
+                    fail(asciiError::OUT_OF_RANGE, position + (p - begin), value);
+                    return p;
+                }
+                inNumber = true;
+                continue;
+            }
+            if (inNumber) {
+                store();
+                if (isComplete()) return p;
+            }
+            if (!isAsciiSpace(*p)) {
+                fail(asciiError::BAD_CHARACTER, position + (p - begin), static_cast<unsigned char>(*p));
+                return p;
+            }
+        }
+        return end;
+    }
+
+    // El último número puede terminar justo al final del texto
+    void finish() {
+        if (inNumber && !isComplete() && !failed()) store();
+    }
+
+    // Comprueba que [begin, end) (desde el byte position) solo tenga espacios:
+    // lo que sigue a la última muestra de un tramo cuando la imagen aún no
+    // está completa, y que la versión secuencial también valida
+    void expectSpaces(const char* begin, const char* end, size_t position) {
+        for (const char* p = begin; p < end && !failed(); p++) {
+            if (!isAsciiSpace(*p)) {
+                fail(asciiError::BAD_CHARACTER, position + (p - begin), static_cast<unsigned char>(*p));
+            }
+        }
+    }
+
+private:
+    void store() {
+        writer.put(value);
+        remaining--;
+        value = 0;
+        inNumber = false;
+    }
+
+    void fail(asciiError::kind type, size_t position, int offending) {
+        error.type = type;
+        error.position = position;
+        error.value = offending;
+    }
+};
+
+// Texto decimal de una muestra (0..65535) sin pasar por iostream
+inline char* formatSample(char* out, unsigned value) {
+    if (value < 10) {
+        out[0] = static_cast<char>('0' + value);
+        return out + 1;
+    }
+    if (value < 100) {
+        out[0] = static_cast<char>('0' + value / 10);
+        out[1] = static_cast<char>('0' + value % 10);
+        return out + 2;
+    }
+    if (value < 1000) {
+        out[0] = static_cast<char>('0' + value / 100);
+        out[1] = static_cast<char>('0' + value / 10 % 10);
+        out[2] = static_cast<char>('0' + value % 10);
+        return out + 3;
+    }
+    char digits[5];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (count > 0) *out++ = digits[--count];
+    return out;
+}
+
+// Caracteres por muestra en el peor caso: "65535 "
+static const size_t MAX_SAMPLE_CHARS = 6;
+
+// Fila y como texto: muestras separadas por un espacio y '\n' al final.
+// out debe tener sitio para width * channelCount * MAX_SAMPLE_CHARS caracteres
+template<typename T>
+inline char* formatAsciiRow(char* out, const imageView* channels, int channelCount, int y) {
+    const T* rows[3];
+    for (int c = 0; c < channelCount; c++) rows[c] = channels[c].row<T>(y);
+    int step = channels[0].step;
+    size_t offset = 0;
+    for (int x = 0; x < channels[0].width; x++, offset += step) {
+        for (int c = 0; c < channelCount; c++) {
+            out = formatSample(out, rows[c][offset]);
+            *out++ = ' ';
+        }
+    }
+    // El separador de la última muestra pasa a ser el fin de fila
+    out[-1] = '\n';
+    return out;
+}
+
+#endif
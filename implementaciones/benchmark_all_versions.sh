@@ -36,27 +36,27 @@ echo "🔧 Compilando todas las versiones..."
 
 # Secuencial
 echo "   Compilando versión secuencial..."
-g++ -std=c++11 -Wall -Wextra -O2 -o filterer \
-    filterer.cpp image.cpp imagesPGM.cpp imagesPPM.cpp \
-    filter.cpp blurFilter.cpp laplaceFilter.cpp sharpenFilter.cpp timer.cpp
+g++ -std=c++11 -Wall -Wextra -O2 -pthread -o filterer \
+    filterer.cpp image.cpp imagesPGM.cpp imagesPPM.cpp bufferPool.cpp mappedFile.cpp imageStream.cpp imageFactory.cpp compressedInput.cpp compressedOutput.cpp tiledFormat.cpp separableKernel.cpp simdStencil.cpp filterPipeline.cpp \
+    filter.cpp blurFilter.cpp laplaceFilter.cpp sharpenFilter.cpp convolutionFilter.cpp convolutionKernel.cpp timer.cpp -lz
 
 # Pthreads
 echo "   Compilando versión pthreads..."
 g++ -std=c++11 -Wall -Wextra -O2 -pthread -o pfilterer \
-    pfilterer.cpp image.cpp imagesPGM.cpp imagesPPM.cpp \
-    filter.cpp pfilter.cpp pfilterBlur.cpp pfilterLaplace.cpp pfilterSharpen.cpp timer.cpp
+    pfilterer.cpp image.cpp imagesPGM.cpp imagesPPM.cpp bufferPool.cpp mappedFile.cpp imageStream.cpp imageFactory.cpp compressedInput.cpp compressedOutput.cpp tiledFormat.cpp separableKernel.cpp simdStencil.cpp \
+    filter.cpp pfilter.cpp pfilterBlur.cpp pfilterLaplace.cpp pfilterSharpen.cpp pfilterConvolution.cpp convolutionKernel.cpp timer.cpp -lz
 
 # OpenMP
 echo "   Compilando versión OpenMP..."
-g++ -std=c++11 -Wall -Wextra -O2 -fopenmp -o opfilterer \
-    opfilterer.cpp image.cpp imagesPGM.cpp imagesPPM.cpp \
-    filter.cpp opfilter.cpp blurFilter.cpp laplaceFilter.cpp sharpenFilter.cpp timer.cpp
+g++ -std=c++11 -Wall -Wextra -O2 -fopenmp -pthread -o opfilterer \
+    opfilterer.cpp image.cpp imagesPGM.cpp imagesPPM.cpp bufferPool.cpp mappedFile.cpp imageStream.cpp imageFactory.cpp compressedInput.cpp compressedOutput.cpp tiledFormat.cpp separableKernel.cpp simdStencil.cpp \
+    filter.cpp opfilter.cpp blurFilter.cpp laplaceFilter.cpp sharpenFilter.cpp convolutionFilter.cpp convolutionKernel.cpp timer.cpp -lz
 
 # MPI
 echo "   Compilando versión MPI..."
-mpic++ -std=c++11 -Wall -Wextra -O2 -o mpifilterer_fixed \
-    mpiFilterer.cpp image.cpp imagesPGM.cpp imagesPPM.cpp \
-    filter.cpp blurFilter.cpp laplaceFilter.cpp sharpenFilter.cpp timer.cpp
+mpic++ -std=c++11 -Wall -Wextra -O2 -pthread -o mpifilterer_fixed \
+    mpiFilterer.cpp image.cpp imagesPGM.cpp imagesPPM.cpp bufferPool.cpp mappedFile.cpp imageStream.cpp imageFactory.cpp compressedInput.cpp compressedOutput.cpp tiledFormat.cpp separableKernel.cpp simdStencil.cpp \
+    filter.cpp blurFilter.cpp laplaceFilter.cpp sharpenFilter.cpp timer.cpp -lz
 
 echo "✅ Compilación completada"
 echo ""
@@ -1,22 +1,12 @@
 #include "blurFilter.h"
+#include "builtinKernels.h"
 #include <iostream>
 
-blurFilter::blurFilter() : filter("blur", 3) {
-    initializeKernel();
+blurFilter::blurFilter() : filter("blur", blurKernel::size) {
 }
 
-blurFilter::~blurFilter() {
-    delete[] kernel;
-}
-
-void blurFilter::initializeKernel() {
-    // Kernel gaussiano 3x3 para suavizado
-    kernel = new int[9] {
-        1, 2, 1,
-        2, 4, 2,
-        1, 2, 1
-    };
-    kernelSum = 16; // Suma de todos los elementos del kernel
+void blurFilter::applyToView(const imageView& src, const imageView& dst, int maxValue) {
+    blurKernel::apply(src, dst, maxValue);
 }
 
 bool blurFilter::applyToPGM(imagesPGM* input, imagesPGM* output) {
@@ -30,19 +20,8 @@ bool blurFilter::applyToPGM(imagesPGM* input, imagesPGM* output) {
     
     std::cout << "Aplicando filtro blur a imagen PGM de " << width << "x" << height << std::endl;
     
-    // Aplicar el filtro de suavizado
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int newValue = applyKernel(input, x, y, kernel, kernelSum);
-            output->setPixel(x, y, newValue);
-        }
-        
-        // Mostrar progreso cada 10% aproximadamente
-        if (height > 10 && y % (height / 10) == 0) {
-            int progress = (y * 100) / height;
-            std::cout << "Progreso: " << progress << "%" << std::endl;
-        }
-    }
+    // La imagen en escala de grises es un único plano
+    applyToView(input->getView(), output->getView(), input->getMaxValue());
     
     std::cout << "Filtro blur aplicado exitosamente a imagen PGM" << std::endl;
     return true;
@@ -59,20 +38,12 @@ bool blurFilter::applyToPPM(imagesPPM* input, imagesPPM* output) {
     
     std::cout << "Aplicando filtro blur a imagen PPM de " << width << "x" << height << std::endl;
     
-    // Aplicar el filtro de suavizado a cada canal RGB
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            RGB newColor = applyKernelRGB(input, x, y, kernel, kernelSum);
-            output->setPixel(x, y, newColor);
-        }
-        
-        // Mostrar progreso cada 10% aproximadamente
-        if (height > 10 && y % (height / 10) == 0) {
-            int progress = (y * 100) / height;
-            std::cout << "Progreso: " << progress << "%" << std::endl;
-        }
+    // Cada canal es una vista independiente: plano contiguo en modo planar
+    // o muestras con paso 3 en modo intercalado, sin copias intermedias
+    for (int c = 0; c < 3; c++) {
+        applyToView(input->getChannelView(c), output->getChannelView(c), input->getMaxValue());
     }
-    
+
     std::cout << "Filtro blur aplicado exitosamente a imagen PPM" << std::endl;
     return true;
 }
\ No newline at end of file
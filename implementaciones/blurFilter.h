@@ -4,18 +4,12 @@
 #include "filter.h"
 
 class blurFilter : public filter {
-private:
-    int* kernel;
-    int kernelSum;
-    
-    void initializeKernel();
-
 public:
     blurFilter();
-    ~blurFilter();
 
     bool applyToPGM(imagesPGM* input, imagesPGM* output) override;
     bool applyToPPM(imagesPPM* input, imagesPPM* output) override;
+    void applyToView(const imageView& src, const imageView& dst, int maxValue) override;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "bufferPool.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+
+bufferPool::bufferPool()
+    : maxCachedBytes(static_cast<size_t>(256) << 20), cachedBytes(0), liveBytes(0), peakBytes(0),
+      hits(0), misses(0), discarded(0) {
+}
+
+bufferPool::~bufferPool() {
+    trim();
+}
+
+bufferPool& bufferPool::instance() {
+    static bufferPool pool;
+    return pool;
+}
+
+int bufferPool::sizeClassFor(size_t bytes) {
+    if (bytes <= (static_cast<size_t>(1) << MIN_CLASS_SHIFT)) {
+        return 0;
+    }
+    // Potencia de dos inmediatamente inferior y subclase (cuartos) que la cubre
+    int shift = 0;
+    while ((bytes >> (shift + 1)) != 0) {
+        shift++;
+    }
+    size_t base = static_cast<size_t>(1) << shift;
+    size_t quarter = base / SUBCLASSES;
+    int sub = static_cast<int>((bytes - base + quarter - 1) / quarter);
+    if (sub == SUBCLASSES) {
+        shift++;
+        sub = 0;
+    }
+    int sizeClass = (shift - MIN_CLASS_SHIFT) * SUBCLASSES + sub;
+    return sizeClass < NUM_CLASSES ? sizeClass : -1;
+}
+
+size_t bufferPool::classSize(int sizeClass) {
+    size_t base = static_cast<size_t>(1) << (MIN_CLASS_SHIFT + sizeClass / SUBCLASSES);
+    return base + (base / SUBCLASSES) * (sizeClass % SUBCLASSES);
+}
+
+unsigned char* bufferPool::acquire(size_t bytes) {
+    int sizeClass = sizeClassFor(bytes);
+    size_t size = sizeClass >= 0 ? classSize(sizeClass) : bytes;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    liveBytes += size;
+    if (liveBytes > peakBytes) {
+        peakBytes = liveBytes;
+    }
+
+    if (sizeClass >= 0 && !freeLists[sizeClass].empty()) {
+        unsigned char* buffer = freeLists[sizeClass].back();
+        freeLists[sizeClass].pop_back();
+        cachedBytes -= size;
+        hits++;
+        return buffer;
+    }
+
+    // Sin buffer libre de esta clase: nueva reserva con espacio para alinear
+    // y para la cabecera que se guarda antes del puntero devuelto
+    misses++;
+    unsigned char* storage = new unsigned char[size + 2 * ALIGNMENT];
+    uintptr_t address = reinterpret_cast<uintptr_t>(storage) + ALIGNMENT;
+    uintptr_t aligned = (address + ALIGNMENT - 1) & ~static_cast<uintptr_t>(ALIGNMENT - 1);
+    unsigned char* buffer = storage + (aligned - reinterpret_cast<uintptr_t>(storage));
+
+    blockHeader* header = reinterpret_cast<blockHeader*>(buffer) - 1;
+    header->storage = storage;
+    header->size = size;
+    header->sizeClass = sizeClass;
+    return buffer;
+}
+
+void bufferPool::release(unsigned char* buffer) {
+    if (!buffer) return;
+
+    const blockHeader* header = reinterpret_cast<const blockHeader*>(buffer) - 1;
+    int sizeClass = header->sizeClass;
+    size_t size = header->size;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    liveBytes -= size;
+    if (sizeClass >= 0 && cachedBytes + size <= maxCachedBytes) {
+        freeLists[sizeClass].push_back(buffer);
+        cachedBytes += size;
+    } else {
+        // Fuera de las clases o por encima del límite: se devuelve al sistema
+        freeBlock(buffer);
+        discarded++;
+    }
+}
+
+void bufferPool::freeBlock(unsigned char* buffer) {
+    const blockHeader* header = reinterpret_cast<const blockHeader*>(buffer) - 1;
+    delete[] header->storage;
+}
+
+void bufferPool::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int c = 0; c < NUM_CLASSES; c++) {
+        for (size_t i = 0; i < freeLists[c].size(); i++) {
+            freeBlock(freeLists[c][i]);
+        }
+        freeLists[c].clear();
+    }
+    cachedBytes = 0;
+}
+
+void bufferPool::setMaxCachedBytes(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maxCachedBytes = bytes;
+}
+
+size_t bufferPool::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+size_t bufferPool::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+size_t bufferPool::getCachedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cachedBytes;
+}
+
+void bufferPool::printStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t requests = hits + misses;
+    double hitRate = requests > 0 ? (100.0 * hits) / requests : 0.0;
+
+    std::cout << "\n=== Estadísticas del pool de buffers ===" << std::endl;
+    std::cout << "Peticiones: " << requests << " (aciertos: " << hits
+              << ", fallos: " << misses << ")" << std::endl;
+    std::cout << "Tasa de aciertos: " << std::fixed << std::setprecision(1) << hitRate << "%" << std::endl;
+    std::cout << "Pico de memoria en uso: " << (peakBytes >> 10) << " KiB" << std::endl;
+    std::cout << "En espera para reutilizar: " << (cachedBytes >> 10) << " KiB" << std::endl;
+    std::cout << "Descartados por el límite: " << discarded << std::endl;
+    std::cout << "=========================================" << std::endl;
+}
@@ -0,0 +1,69 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Reserva de buffers de píxeles reutilizables entre imágenes y trabajos.
+// Cada petición se redondea a una clase de tamaño (cuatro clases por cada
+// potencia de dos, desperdicio máximo del 25%); al liberar, el buffer vuelve
+// a la lista de su clase en lugar de devolverse al sistema, de modo que las
+// imágenes siguientes del mismo tamaño reutilizan memoria ya mapeada.
+class bufferPool {
+public:
+    static const size_t ALIGNMENT = 64;
+
+    // Instancia compartida por todas las imágenes del proceso
+    static bufferPool& instance();
+
+    // Buffer de al menos bytes bytes, alineado a ALIGNMENT (contenido indefinido)
+    unsigned char* acquire(size_t bytes);
+    // Devuelve un buffer obtenido con acquire; nullptr se ignora
+    void release(unsigned char* buffer);
+
+    // Libera todos los buffers en espera
+    void trim();
+    // Límite de bytes guardados en espera; lo que exceda se libera
+    void setMaxCachedBytes(size_t bytes);
+
+    // Estadísticas
+    size_t getHits() const;
+    size_t getMisses() const;
+    size_t getCachedBytes() const;
+    void printStatistics() const;
+
+private:
+    // Clases de tamaño: 4 KiB, 5 KiB, 6 KiB, 7 KiB, 8 KiB, 10 KiB, ...
+    static const int MIN_CLASS_SHIFT = 12;
+    static const int SUBCLASSES = 4;
+    static const int NUM_CLASSES = (48 - MIN_CLASS_SHIFT) * SUBCLASSES;
+
+    // Cabecera guardada justo antes del puntero alineado
+    struct blockHeader {
+        unsigned char* storage;  // Puntero devuelto por new[]
+        size_t size;             // Bytes utilizables (tamaño de la clase)
+        int sizeClass;           // -1 si la petición excede todas las clases
+    };
+
+    std::vector<unsigned char*> freeLists[NUM_CLASSES];
+    size_t maxCachedBytes;
+    size_t cachedBytes;
+    size_t liveBytes;
+    size_t peakBytes;
+    size_t hits;
+    size_t misses;
+    size_t discarded;
+    mutable std::mutex mutex;
+
+    bufferPool();
+    ~bufferPool();
+    bufferPool(const bufferPool&);
+    bufferPool& operator=(const bufferPool&);
+
+    static int sizeClassFor(size_t bytes);
+    static size_t classSize(int sizeClass);
+    static void freeBlock(unsigned char* buffer);
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef BUILTIN_KERNELS_H
+#define BUILTIN_KERNELS_H
+
+#include "fixedKernel.h"
+
+// Kernels 3x3 de los filtros incluidos. Los comparten las versiones
+// secuencial (filterer), pthreads (pfilterer) y OpenMP (opfilterer)
+
+// Gaussiano para suavizado; la suma de los coeficientes es 16. Es separable
+// ([1,2,1] x [1,2,1]), pero con 3x3 el bucle desenrollado de fixedKernel es
+// unas tres veces más rápido que las dos pasadas de separableKernel, que
+// queda para los kernels definidos en tiempo de ejecución (filter::convolveView)
+typedef fixedKernel<16, false,
+    1, 2, 1,
+    2, 4, 2,
+    1, 2, 1> blurKernel;
+
+// Laplaciano para detección de bordes (valor absoluto de la respuesta)
+typedef fixedKernel<1, true,
+     0, -1,  0,
+    -1,  4, -1,
+     0, -1,  0> laplaceKernel;
+
+// Realce: la imagen más su Laplaciano
+typedef fixedKernel<1, false,
+     0, -1,  0,
+    -1,  5, -1,
+     0, -1,  0> sharpenKernel;
+
+#endif
@@ -0,0 +1,113 @@
+#include "compressedInput.h"
+#include <iostream>
+#include <cstring>
+
+// Tamaño de los bloques comprimidos y del texto descomprimido
+static const size_t COMPRESSED_BLOCK_BYTES = static_cast<size_t>(256) << 10;
+static const size_t TEXT_BLOCK_BYTES = static_cast<size_t>(1) << 20;
+
+gzipInputBuffer::gzipInputBuffer(std::streambuf* compressedSource)
+    : source(compressedSource), compressed(COMPRESSED_BLOCK_BYTES), text(TEXT_BLOCK_BYTES),
+      textStart(0), streamEnded(false), failed(false) {
+    memset(&stream, 0, sizeof(stream));
+    // 16 + MAX_WBITS: formato gzip (cabecera y CRC), no zlib
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+        std::cerr << "Error: No se pudo iniciar la descompresión gzip" << std::endl;
+        failed = true;
+    }
+    setg(text.data(), text.data(), text.data());
+}
+
+gzipInputBuffer::~gzipInputBuffer() {
+    inflateEnd(&stream);
+}
+
+gzipInputBuffer::int_type gzipInputBuffer::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    textStart += static_cast<size_t>(egptr() - eback());
+    setg(text.data(), text.data(), text.data());
+    if (failed) {
+        return traits_type::eof();
+    }
+
+    stream.next_out = reinterpret_cast<Bytef*>(text.data());
+    stream.avail_out = static_cast<uInt>(text.size());
+    while (stream.avail_out == text.size()) {
+        if (stream.avail_in == 0) {
+            std::streamsize got = source->sgetn(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+            if (got <= 0) {
+                // Fin del archivo: válido solo entre miembros
+                if (!streamEnded) {
+                    std::cerr << "Error: Archivo gzip incompleto" << std::endl;
+                    failed = true;
+                }
+                break;
+            }
+            stream.next_in = reinterpret_cast<Bytef*>(compressed.data());
+            stream.avail_in = static_cast<uInt>(got);
+        }
+        if (streamEnded) {
+            // Otro miembro concatenado a continuación
+            inflateReset(&stream);
+            streamEnded = false;
+        }
+        int status = inflate(&stream, Z_NO_FLUSH);
+        if (status == Z_STREAM_END) {
+            streamEnded = true;
+        } else if (status != Z_OK && status != Z_BUF_ERROR) {
+            std::cerr << "Error: Archivo gzip dañado: " << (stream.msg ? stream.msg : "datos inválidos") << std::endl;
+            failed = true;
+            break;
+        }
+    }
+
+    size_t produced = text.size() - stream.avail_out;
+    if (produced == 0) {
+        return traits_type::eof();
+    }
+    setg(text.data(), text.data(), text.data() + produced);
+    return traits_type::to_int_type(*gptr());
+}
+
+gzipInputBuffer::pos_type gzipInputBuffer::seekoff(off_type offset, std::ios_base::seekdir direction,
+                                                   std::ios_base::openmode which) {
+    if (offset != 0 || direction != std::ios_base::cur || !(which & std::ios_base::in)) {
+        return pos_type(off_type(-1));
+    }
+    return pos_type(static_cast<off_type>(textStart + (gptr() - eback())));
+}
+
+// Volver a la posición actual es lo único posible (sin efecto)
+gzipInputBuffer::pos_type gzipInputBuffer::seekpos(pos_type position, std::ios_base::openmode which) {
+    pos_type current = seekoff(0, std::ios_base::cur, which);
+    return position == current ? current : pos_type(off_type(-1));
+}
+
+imageInput::imageInput() : inflater(nullptr), text(nullptr) {
+}
+
+imageInput::~imageInput() {
+    if (inflater) {
+        delete text;
+        delete inflater;
+    }
+}
+
+bool imageInput::open(const char* filename) {
+    file.open(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se puede abrir el archivo " << filename << std::endl;
+        return false;
+    }
+    // Ninguna imagen PNM empieza con 0x1f: basta el primer byte de la firma
+    // (el resto de la cabecera gzip lo valida inflate)
+    if (file.peek() == 0x1f) {
+        inflater = new gzipInputBuffer(file.rdbuf());
+        text = new std::istream(inflater);
+    } else {
+        text = &file;
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef COMPRESSED_INPUT_H
+#define COMPRESSED_INPUT_H
+
+#include <fstream>
+#include <istream>
+#include <streambuf>
+#include <vector>
+#include <zlib.h>
+
+// streambuf de lectura que descomprime gzip (.pgm.gz, .ppm.gz) a medida que
+// el analizador pide texto: lee bloques comprimidos de source y los infla en
+// un buffer de 1 MiB, sin archivo temporal ni la imagen descomprimida entera.
+// Admite varios miembros gzip concatenados. Solo se puede consultar la
+// posición actual (tellg); cualquier otro desplazamiento falla
+class gzipInputBuffer : public std::streambuf {
+private:
+    std::streambuf* source;
+    z_stream stream;
+    std::vector<char> compressed;
+    std::vector<char> text;
+    size_t textStart;     // Bytes descomprimidos anteriores a text
+    bool streamEnded;     // Terminó un miembro y no se ha empezado otro
+    bool failed;
+
+protected:
+    int_type underflow() override;
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction,
+                     std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type position, std::ios_base::openmode which) override;
+
+public:
+    explicit gzipInputBuffer(std::streambuf* compressedSource);
+    ~gzipInputBuffer();
+
+    bool hasFailed() const { return failed; }
+};
+
+// Archivo de imagen abierto una sola vez. Si empieza con la firma gzip
+// (0x1f 0x8b) las lecturas pasan por gzipInputBuffer; si no, se leen
+// directamente del archivo
+class imageInput {
+private:
+    std::ifstream file;
+    gzipInputBuffer* inflater;
+    std::istream* text;
+
+public:
+    imageInput();
+    ~imageInput();
+
+    // false (con el mensaje de error) si no se puede abrir
+    bool open(const char* filename);
+    std::istream& stream() { return *text; }
+    bool isCompressed() const { return inflater != nullptr; }
+};
+
+#endif
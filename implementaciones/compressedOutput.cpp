@@ -0,0 +1,193 @@
+#include "compressedOutput.h"
+#include <iostream>
+#include <cstring>
+#include <pthread.h>
+#include <unistd.h>
+
+// Texto por bloque comprimido de forma independiente
+static const size_t BLOCK_BYTES = static_cast<size_t>(1) << 20;
+
+gzipOutputBuffer::gzipOutputBuffer(std::streambuf* compressedDestination, int threads)
+    : destination(compressedDestination), threadCount(threads < 1 ? 1 : threads),
+      blocks(threadCount), compressed(threadCount), blockCrcs(threadCount), blockFailed(threadCount),
+      filledBlocks(0), crc(crc32(0L, Z_NULL, 0)), totalBytes(0), failed(false), finished(false) {
+    for (int i = 0; i < threadCount; i++) {
+        blocks[i].resize(BLOCK_BYTES);
+    }
+    setp(blocks[0].data(), blocks[0].data() + BLOCK_BYTES);
+
+    // Cabecera gzip mínima: deflate, sin nombre ni fecha, sistema Unix
+    static const unsigned char header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 3 };
+    writeBytes(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+gzipOutputBuffer::~gzipOutputBuffer() {
+}
+
+bool gzipOutputBuffer::writeBytes(const char* data, size_t bytes) {
+    if (!failed && destination->sputn(data, static_cast<std::streamsize>(bytes)) != static_cast<std::streamsize>(bytes)) {
+        failed = true;
+    }
+    return !failed;
+}
+
+// Bloque deflate independiente (sin diccionario previo)
+void gzipOutputBuffer::compressBlock(int block, size_t bytes, bool last) {
+    const char* data = blocks[block].data();
+    blockCrcs[block] = crc32(0L, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(bytes));
+    blockFailed[block] = 0;
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // -MAX_WBITS: deflate sin envoltura; la cabecera gzip se escribe aparte
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        blockFailed[block] = 1;
+        return;
+    }
+    // Margen para el bloque vacío que añade Z_SYNC_FLUSH
+    std::vector<char>& out = compressed[block];
+    out.resize(deflateBound(&stream, static_cast<uLong>(bytes)) + 64);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = static_cast<uInt>(bytes);
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    int status = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    if ((last && status != Z_STREAM_END) || (!last && (status != Z_OK || stream.avail_in != 0))) {
+        blockFailed[block] = 1;
+    }
+    out.resize(out.size() - stream.avail_out);
+    deflateEnd(&stream);
+}
+
+void* gzipOutputBuffer::compressThread(void* arg) {
+    compressJob* job = static_cast<compressJob*>(arg);
+    job->buffer->compressBlock(job->block, job->bytes, job->last);
+    return nullptr;
+}
+
+// Comprime count bloques (todos llenos salvo el último, de lastBytes) en
+// paralelo y los escribe en orden. final marca el último bloque del archivo
+bool gzipOutputBuffer::compressRound(int count, size_t lastBytes, bool final) {
+    std::vector<compressJob> jobs(count);
+    std::vector<pthread_t> threads(count);
+    std::vector<char> started(count, 0);
+    for (int i = 0; i < count; i++) {
+        jobs[i].buffer = this;
+        jobs[i].block = i;
+        jobs[i].bytes = i == count - 1 ? lastBytes : BLOCK_BYTES;
+        jobs[i].last = final && i == count - 1;
+    }
+    // El hilo que llama comprime el primer bloque; si no se puede crear un
+    // hilo, ese bloque también se comprime aquí
+    for (int i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], nullptr, compressThread, &jobs[i]) == 0;
+    }
+    compressBlock(0, jobs[0].bytes, jobs[0].last);
+    for (int i = 1; i < count; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], nullptr);
+        } else {
+            compressBlock(i, jobs[i].bytes, jobs[i].last);
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (blockFailed[i]) {
+            std::cerr << "Error: No se pudo comprimir el bloque gzip" << std::endl;
+            failed = true;
+            return false;
+        }
+        crc = crc32_combine(crc, blockCrcs[i], static_cast<z_off_t>(jobs[i].bytes));
+        totalBytes += static_cast<uLong>(jobs[i].bytes);
+        if (!writeBytes(compressed[i].data(), compressed[i].size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+gzipOutputBuffer::int_type gzipOutputBuffer::overflow(int_type c) {
+    if (failed || finished) {
+        return traits_type::eof();
+    }
+    // Bloque actual lleno: pasa al siguiente o, si la ronda está completa,
+    // se comprime y se vuelve a empezar por el primero
+    filledBlocks++;
+    if (filledBlocks == threadCount) {
+        if (!compressRound(threadCount, BLOCK_BYTES, false)) {
+            return traits_type::eof();
+        }
+        filledBlocks = 0;
+    }
+    char* block = blocks[filledBlocks].data();
+    setp(block, block + BLOCK_BYTES);
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+bool gzipOutputBuffer::finish() {
+    if (finished) {
+        return !failed;
+    }
+    finished = true;
+    if (failed) {
+        return false;
+    }
+    // Los bloques llenos más el actual (puede estar vacío: aun así lleva
+    // la marca de final del flujo deflate)
+    size_t lastBytes = static_cast<size_t>(pptr() - pbase());
+    if (!compressRound(filledBlocks + 1, lastBytes, true)) {
+        return false;
+    }
+
+    // Final gzip: CRC32 y tamaño del texto, en little-endian
+    unsigned char trailer[8];
+    for (int i = 0; i < 4; i++) {
+        trailer[i] = static_cast<unsigned char>((crc >> (8 * i)) & 0xff);
+        trailer[4 + i] = static_cast<unsigned char>((totalBytes >> (8 * i)) & 0xff);
+    }
+    return writeBytes(reinterpret_cast<const char*>(trailer), sizeof(trailer));
+}
+
+imageOutput::imageOutput() : deflater(nullptr), text(nullptr) {
+}
+
+imageOutput::~imageOutput() {
+    if (deflater) {
+        delete text;
+        delete deflater;
+    }
+}
+
+bool imageOutput::isCompressedName(const char* filename) {
+    size_t length = strlen(filename);
+    return length > 3 && strcmp(filename + length - 3, ".gz") == 0;
+}
+
+bool imageOutput::open(const char* filename) {
+    file.open(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se puede crear el archivo " << filename << std::endl;
+        return false;
+    }
+    if (isCompressedName(filename)) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        deflater = new gzipOutputBuffer(file.rdbuf(), cores > 0 ? static_cast<int>(cores) : 1);
+        text = new std::ostream(deflater);
+    } else {
+        text = &file;
+    }
+    return true;
+}
+
+bool imageOutput::close() {
+    bool ok = static_cast<bool>(*text);
+    if (deflater) {
+        ok = deflater->finish() && ok;
+    }
+    file.close();
+    return ok && !file.fail();
+}
@@ -0,0 +1,77 @@
+#ifndef COMPRESSED_OUTPUT_H
+#define COMPRESSED_OUTPUT_H
+
+#include <fstream>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+#include <zlib.h>
+
+// streambuf de escritura que produce un gzip válido comprimiendo en paralelo
+// (como pigz): el texto se corta en bloques independientes de 1 MiB, cada
+// ronda de threadCount bloques se comprime a la vez en hilos distintos y los
+// resultados se escriben en orden. Los bloques terminan con Z_SYNC_FLUSH
+// (alineados a byte y sin marca de final), así que concatenados forman un
+// único flujo deflate; el último usa Z_FINISH. El CRC del miembro se obtiene
+// combinando los de cada bloque con crc32_combine
+class gzipOutputBuffer : public std::streambuf {
+private:
+    std::streambuf* destination;
+    int threadCount;
+    std::vector<std::vector<char> > blocks;      // Texto de la ronda actual
+    std::vector<std::vector<char> > compressed;  // Resultado de cada bloque
+    std::vector<uLong> blockCrcs;
+    std::vector<char> blockFailed;
+    int filledBlocks;       // Bloques llenos en la ronda actual
+    uLong crc;              // CRC32 del texto ya comprimido
+    uLong totalBytes;       // Tamaño del texto ya comprimido (módulo 2^32 en el gzip)
+    bool failed;
+    bool finished;
+
+    struct compressJob {
+        gzipOutputBuffer* buffer;
+        int block;
+        size_t bytes;
+        bool last;
+    };
+
+    void compressBlock(int block, size_t bytes, bool last);
+    bool compressRound(int count, size_t lastBytes, bool final);
+    bool writeBytes(const char* data, size_t bytes);
+    static void* compressThread(void* arg);
+
+protected:
+    int_type overflow(int_type c) override;
+
+public:
+    gzipOutputBuffer(std::streambuf* compressedDestination, int threads);
+    ~gzipOutputBuffer();
+
+    // Comprime lo pendiente y escribe el final del gzip (CRC y tamaño)
+    bool finish();
+};
+
+// Archivo de imagen de salida. Si el nombre termina en ".gz" lo escrito en
+// stream se comprime con gzipOutputBuffer (un hilo por núcleo); si no, va
+// directamente al archivo
+class imageOutput {
+private:
+    std::ofstream file;
+    gzipOutputBuffer* deflater;
+    std::ostream* text;
+
+public:
+    imageOutput();
+    ~imageOutput();
+
+    // false (con el mensaje de error) si no se puede crear
+    bool open(const char* filename);
+    std::ostream& stream() { return *text; }
+    bool isCompressed() const { return deflater != nullptr; }
+    // Termina el gzip (si lo hay) y cierra; false si alguna escritura falló
+    bool close();
+
+    static bool isCompressedName(const char* filename);
+};
+
+#endif
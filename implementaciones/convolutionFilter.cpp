@@ -0,0 +1,51 @@
+#include "convolutionFilter.h"
+#include <iostream>
+
+convolutionFilter::convolutionFilter(const convolutionKernel& userKernel)
+    : filter("convolution", userKernel.getSize()), kernel(userKernel) {
+}
+
+void convolutionFilter::applyToView(const imageView& src, const imageView& dst, int maxValue) {
+    convolveView(src, dst, kernel.getCoefficients(), kernel.getDivisor(), maxValue, kernel.getOffset());
+}
+
+bool convolutionFilter::applyToPGM(imagesPGM* input, imagesPGM* output) {
+    if (!input || !output) {
+        std::cerr << "Error: Imágenes nulas en convolutionFilter::applyToPGM" << std::endl;
+        return false;
+    }
+    
+    int width = input->getWidth();
+    int height = input->getHeight();
+    
+    std::cout << "Aplicando kernel " << kernelSize << "x" << kernelSize << " a imagen PGM de "
+              << width << "x" << height << std::endl;
+    
+    // La imagen en escala de grises es un único plano
+    applyToView(input->getView(), output->getView(), input->getMaxValue());
+    
+    std::cout << "Kernel " << kernelSize << "x" << kernelSize << " aplicado exitosamente a imagen PGM" << std::endl;
+    return true;
+}
+
+bool convolutionFilter::applyToPPM(imagesPPM* input, imagesPPM* output) {
+    if (!input || !output) {
+        std::cerr << "Error: Imágenes nulas en convolutionFilter::applyToPPM" << std::endl;
+        return false;
+    }
+    
+    int width = input->getWidth();
+    int height = input->getHeight();
+    
+    std::cout << "Aplicando kernel " << kernelSize << "x" << kernelSize << " a imagen PPM de "
+              << width << "x" << height << std::endl;
+    
+    // Cada canal es una vista independiente: plano contiguo en modo planar
+    // o muestras con paso 3 en modo intercalado, sin copias intermedias
+    for (int c = 0; c < 3; c++) {
+        applyToView(input->getChannelView(c), output->getChannelView(c), input->getMaxValue());
+    }
+
+    std::cout << "Kernel " << kernelSize << "x" << kernelSize << " aplicado exitosamente a imagen PPM" << std::endl;
+    return true;
+}
@@ -0,0 +1,24 @@
+#ifndef CONVOLUTION_FILTER_H
+#define CONVOLUTION_FILTER_H
+
+#include "filter.h"
+#include "convolutionKernel.h"
+
+// Filtro con un kernel NxN del usuario (ver convolutionKernel). Va por el
+// motor común de filter: dos pasadas si el kernel es separable y, si no,
+// acumulación por coeficientes sobre filas completas
+class convolutionFilter : public filter {
+private:
+    convolutionKernel kernel;
+
+public:
+    convolutionFilter(const convolutionKernel& userKernel);
+
+    const convolutionKernel& getKernel() const { return kernel; }
+
+    bool applyToPGM(imagesPGM* input, imagesPGM* output) override;
+    bool applyToPPM(imagesPPM* input, imagesPPM* output) override;
+    void applyToView(const imageView& src, const imageView& dst, int maxValue) override;
+};
+
+#endif
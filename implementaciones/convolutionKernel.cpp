@@ -0,0 +1,136 @@
+#include "convolutionKernel.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <climits>
+#include <sys/stat.h>
+
+convolutionKernel::convolutionKernel() : size(0), divisor(1), offset(0) {
+}
+
+// Entero completo de token (sin restos como "3x" o "1.5")
+static bool parseInteger(const std::string& token, int& value) {
+    const char* text = token.c_str();
+    char* end = nullptr;
+    long number = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || number < INT_MIN || number > INT_MAX) {
+        return false;
+    }
+    value = static_cast<int>(number);
+    return true;
+}
+
+bool convolutionKernel::load(const char* argument) {
+    // Un archivo existente tiene prioridad aunque su nombre empiece por un
+    // número ("5x5_gauss.txt")
+    struct stat info;
+    if (stat(argument, &info) == 0) {
+        return loadFromFile(argument);
+    }
+    const char* text = argument;
+    while (isspace(static_cast<unsigned char>(*text))) text++;
+    bool inlineList = isdigit(static_cast<unsigned char>(*text)) || *text == '-' || *text == '+' ||
+                      strncmp(text, "divisor", 7) == 0 || strncmp(text, "offset", 6) == 0;
+    if (inlineList) {
+        return parse(argument, "la línea de órdenes");
+    }
+    return loadFromFile(argument);
+}
+
+bool convolutionKernel::loadFromFile(const char* filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        std::cerr << "Error: No se pudo abrir el archivo de kernel " << filename << std::endl;
+        return false;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    return parse(content.str().c_str(), filename);
+}
+
+bool convolutionKernel::parse(const char* text, const char* source) {
+    std::vector<int> values;
+    bool hasDivisor = false;
+    int newDivisor = 1;
+    int newOffset = 0;
+
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        for (size_t i = 0; i < line.size(); i++) {
+            if (line[i] == ',' || line[i] == ';' || line[i] == '=') line[i] = ' ';
+        }
+
+        std::istringstream tokens(line);
+        std::string token;
+        while (tokens >> token) {
+            if (token == "divisor" || token == "offset") {
+                std::string value;
+                int number;
+                if (!(tokens >> value) || !parseInteger(value, number)) {
+                    std::cerr << "Error: Falta el valor de '" << token << "' en " << source << std::endl;
+                    return false;
+                }
+                if (token == "divisor") {
+                    hasDivisor = true;
+                    newDivisor = number;
+                } else {
+                    newOffset = number;
+                }
+                continue;
+            }
+            int number;
+            if (!parseInteger(token, number)) {
+                std::cerr << "Error: Coeficiente inválido '" << token << "' en " << source << std::endl;
+                return false;
+            }
+            values.push_back(number);
+        }
+    }
+
+    int count = static_cast<int>(values.size());
+    int side = 1;
+    while (side * side < count) side++;
+    if (count == 0 || side * side != count || side % 2 == 0) {
+        std::cerr << "Error: El kernel de " << source << " tiene " << count
+                  << " coeficientes; debe ser cuadrado y de lado impar (9, 25, 49...)" << std::endl;
+        return false;
+    }
+
+    long weight = 0;
+    long sum = 0;
+    for (int i = 0; i < count; i++) {
+        weight += labs(values[i]);
+        sum += values[i];
+    }
+    if (weight > MAX_WEIGHT) {
+        std::cerr << "Error: La suma de |coeficientes| del kernel (" << weight
+                  << ") supera " << MAX_WEIGHT << std::endl;
+        return false;
+    }
+    if (newOffset < -MAX_OFFSET || newOffset > MAX_OFFSET) {
+        std::cerr << "Error: El desplazamiento del kernel (" << newOffset << ") debe estar entre "
+                  << -MAX_OFFSET << " y " << MAX_OFFSET << std::endl;
+        return false;
+    }
+    if (!hasDivisor) {
+        newDivisor = sum > 0 ? static_cast<int>(sum) : 1;
+    } else if (newDivisor < 1) {
+        std::cerr << "Error: El divisor del kernel debe ser positivo (" << newDivisor << ")" << std::endl;
+        return false;
+    }
+
+    size = side;
+    coefficients.swap(values);
+    divisor = newDivisor;
+    offset = newOffset;
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef CONVOLUTION_KERNEL_H
+#define CONVOLUTION_KERNEL_H
+
+#include <vector>
+
+// Kernel de convolución definido por el usuario: size x size coeficientes
+// enteros (size impar: 3, 5, 7, 11...), divisor y desplazamiento. Cada
+// muestra de salida es suma / divisor + offset, recortada a [0, maxValue].
+// El texto (archivo o línea de órdenes) es una lista de enteros separados
+// por espacios, comas, punto y coma o saltos de línea, por filas; el lado se
+// deduce de la cantidad. "divisor N" y "offset N" (o "divisor=N") fijan esos
+// valores y '#' comenta hasta el final de la línea. Ejemplo (gaussiano 5x5):
+//   divisor 256
+//   1  4  6  4 1
+//   4 16 24 16 4
+//   6 24 36 24 6
+//   4 16 24 16 4
+//   1  4  6  4 1
+// Sin divisor se usa la suma de los coeficientes si es positiva, o 1
+class convolutionKernel {
+private:
+    int size;
+    std::vector<int> coefficients;
+    int divisor;
+    int offset;
+
+public:
+    // Suma máxima de |coeficientes|: con muestras de 16 bits la suma de un
+    // píxel cabe en un int
+    static const int MAX_WEIGHT = 32767;
+    // Desplazamiento máximo en valor absoluto: el mayor rango de muestra
+    // (16 bits); suma / divisor + offset no desborda un int
+    static const int MAX_OFFSET = 65535;
+
+    convolutionKernel();
+
+    // argument es un archivo de kernel o, si no existe tal archivo y empieza
+    // por un número o por "divisor"/"offset", la lista de coeficientes en sí
+    bool load(const char* argument);
+    bool loadFromFile(const char* filename);
+    // source solo se usa en los mensajes de error
+    bool parse(const char* text, const char* source);
+
+    int getSize() const { return size; }
+    int getRadius() const { return size / 2; }
+    const int* getCoefficients() const { return coefficients.data(); }
+    int getDivisor() const { return divisor; }
+    int getOffset() const { return offset; }
+};
+
+#endif
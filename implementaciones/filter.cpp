@@ -1,6 +1,12 @@
 #include "filter.h"
+#include "imageStream.h"
+#include "separableKernel.h"
+#include "simdStencil.h"
 #include <cstring>
 #include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
 
 filter::filter(const char* name, int size) : kernelSize(size) {
     filterName = new char[strlen(name) + 1];
@@ -17,95 +23,264 @@ bool filter::apply(Image* input, Image* output) {
         return false;
     }
     
-    // Verificar que las imágenes sean del mismo tipo
-    if (strcmp(input->getMagicNumber(), output->getMagicNumber()) != 0) {
+    // Verificar que las imágenes sean del mismo tipo (ASCII o binario da igual)
+    if (input->isGrayscale() != output->isGrayscale() || input->isColor() != output->isColor()) {
         std::cerr << "Error: Las imágenes deben ser del mismo tipo" << std::endl;
         return false;
     }
     
-    // Aplicar filtro según el tipo
-    if (strcmp(input->getMagicNumber(), "P2") == 0) {
+    // Aplicar filtro según el tipo; el relleno de la salida se actualiza para
+    // que pueda usarse como entrada de otro filtro
+    bool applied = false;
+    bool supported = false;
+    if (input->isGrayscale()) {
         imagesPGM* pgmInput = dynamic_cast<imagesPGM*>(input);
         imagesPGM* pgmOutput = dynamic_cast<imagesPGM*>(output);
         if (pgmInput && pgmOutput) {
-            return applyToPGM(pgmInput, pgmOutput);
+            supported = true;
+            applied = applyToPGM(pgmInput, pgmOutput);
         }
-    } else if (strcmp(input->getMagicNumber(), "P3") == 0) {
+    } else if (input->isColor()) {
         imagesPPM* ppmInput = dynamic_cast<imagesPPM*>(input);
         imagesPPM* ppmOutput = dynamic_cast<imagesPPM*>(output);
         if (ppmInput && ppmOutput) {
-            return applyToPPM(ppmInput, ppmOutput);
+            supported = true;
+            applied = applyToPPM(ppmInput, ppmOutput);
         }
     }
+    if (supported) {
+        if (applied) {
+            output->fillHalo();
+        }
+        return applied;
+    }
     
     std::cerr << "Error: Tipo de imagen no soportado para filtros" << std::endl;
     return false;
 }
 
-int filter::clampValue(int value, int min, int max) {
-    if (value < min) return min;
-    if (value > max) return max;
-    return value;
+// Vistas de los canales de una fila intercalada (channels muestras por píxel)
+static void rowChannelViews(unsigned char* row, int width, int stride, int height, int channels,
+                            int sampleBytes, imageView* views) {
+    for (int c = 0; c < channels; c++) {
+        views[c] = imageView(row + c * sampleBytes, width, height, stride, channels, sampleBytes);
+    }
 }
 
-int filter::getClampedPixel(imagesPGM* image, int x, int y) {
-    // Manejo de bordes por repetición (clamping)
-    x = clampValue(x, 0, image->getWidth() - 1);
-    y = clampValue(y, 0, image->getHeight() - 1);
-    return image->getPixel(x, y);
+bool filter::applyStreaming(const char* inputFile, const char* outputFile) {
+    imageStream input;
+    if (!input.loadFromFile(inputFile)) {
+        return false;
+    }
+    imageStream output;
+    output.copyHeader(input);
+    if (!output.saveToFile(outputFile)) {
+        return false;
+    }
+
+    int width = input.getWidth();
+    int height = input.getHeight();
+    int channels = input.getChannelCount();
+    int sampleBytes = input.getSampleBytes();
+    int maxValue = input.getMaxValue();
+    int radius = kernelSize / 2;
+
+    std::cout << "Aplicando filtro " << filterName << " en flujo a imagen de "
+              << width << "x" << height << std::endl;
+
+    // Anillo de kernelSize filas con radius columnas replicadas a cada lado.
+    // La fila virtual v (de -radius a height - 1 + radius, las de fuera
+    // repiten el borde) va a la posición (v + radius) % kernelSize y se copia
+    // también kernelSize posiciones más abajo: así las kernelSize filas que
+    // necesita cualquier fila de salida quedan consecutivas en memoria
+    int slots = 2 * kernelSize - 1;
+    int stride = (width + 2 * radius) * channels;
+    size_t slotBytes = static_cast<size_t>(stride) * sampleBytes;
+    size_t leftBytes = static_cast<size_t>(radius) * channels * sampleBytes;
+    std::vector<unsigned char> ring(slots * slotBytes);
+    std::vector<unsigned char> outRow(static_cast<size_t>(width) * channels * sampleBytes);
+    imageView rowViews[3];
+    imageView outViews[3];
+    rowChannelViews(outRow.data(), width, width * channels, 1, channels, sampleBytes, outViews);
+
+    for (int v = 0; v < height + radius; v++) {
+        int slot = (v + radius) % kernelSize;
+        unsigned char* slotRow = ring.data() + slot * slotBytes;
+        if (v < height) {
+            rowChannelViews(slotRow + leftBytes, width, stride, 1, channels, sampleBytes, rowViews);
+            if (!input.readRows(rowViews)) {
+                return false;
+            }
+            for (int c = 0; c < channels; c++) {
+                for (int k = 1; k <= radius; k++) {
+                    rowViews[c].putSample(-k, 0, rowViews[c].sample(0, 0));
+                    rowViews[c].putSample(width - 1 + k, 0, rowViews[c].sample(width - 1, 0));
+                }
+            }
+        } else {
+            // Debajo de la imagen se repite la última fila
+            int lastSlot = (height - 1 + radius) % kernelSize;
+            memcpy(slotRow, ring.data() + lastSlot * slotBytes, slotBytes);
+        }
+        if (slot < kernelSize - 1) {
+            memcpy(slotRow + kernelSize * slotBytes, slotRow, slotBytes);
+        }
+        // Encima de la imagen se repite la primera fila
+        if (v == 0) {
+            for (int u = -radius; u < 0; u++) {
+                int above = u + radius;
+                memcpy(ring.data() + above * slotBytes, slotRow, slotBytes);
+                if (above < kernelSize - 1) {
+                    memcpy(ring.data() + (above + kernelSize) * slotBytes, slotRow, slotBytes);
+                }
+            }
+        }
+
+        // La fila y = v - radius ya tiene todas sus vecinas
+        int y = v - radius;
+        if (y < 0) continue;
+        unsigned char* center = ring.data() + (y % kernelSize + radius) * slotBytes + leftBytes;
+        rowChannelViews(center, width, stride, 1, channels, sampleBytes, rowViews);
+        for (int c = 0; c < channels; c++) {
+            rowViews[c].haloLeft = rowViews[c].haloTop = radius;
+            rowViews[c].haloRight = rowViews[c].haloBottom = radius;
+            applyToView(rowViews[c], outViews[c], maxValue);
+        }
+        if (!output.writeRows(outViews)) {
+            std::cerr << "Error: No se pudo escribir en " << outputFile << std::endl;
+            return false;
+        }
+    }
+
+    if (!output.finish()) {
+        std::cerr << "Error: No se pudo escribir en " << outputFile << std::endl;
+        return false;
+    }
+    std::cout << "Filtro " << filterName << " aplicado en flujo exitosamente" << std::endl;
+    return true;
 }
 
-RGB filter::getClampedPixelRGB(imagesPPM* image, int x, int y) {
-    // Manejo de bordes por repetición (clamping)
-    x = clampValue(x, 0, image->getWidth() - 1);
-    y = clampValue(y, 0, image->getHeight() - 1);
-    return image->getPixel(x, y);
+void filter::convolveView(const imageView& src, const imageView& dst,
+                          const int* kernel, int kernelSum, int maxValue, int offset) {
+    // Kernels 3x3 con instrucciones vectoriales si la CPU y el kernel lo admiten.
+    // Sin valor absoluto: solo lo pide el Laplaciano incluido (fixedKernel)
+    if (kernelSize == 3 && offset == 0 &&
+        simdStencil::convolve3x3(src, dst, kernel, kernelSum, false, maxValue)) {
+        return;
+    }
+    // Kernels separables (producto de una columna y una fila): dos pasadas
+    separableKernel factors(kernel, kernelSize);
+    if (factors.isSeparable()) {
+        factors.convolve(src, dst, kernelSum, maxValue, offset);
+        return;
+    }
+    if (src.sampleBytes == 1) {
+        convolveViewSamples<uint8_t>(src, dst, kernel, kernelSum, maxValue, offset);
+    } else {
+        convolveViewSamples<uint16_t>(src, dst, kernel, kernelSum, maxValue, offset);
+    }
 }
 
-int filter::applyKernel(imagesPGM* image, int x, int y, const int* kernel, int kernelSum) {
-    int sum = 0;
+// Suma de una muestra de salida con las coordenadas recortadas a la zona legible (marco)
+template<typename T>
+static int convolveClampedSample(const imageView& src, const T* const* rows, int x,
+                                 const int* kernel, int kernelSize) {
     int halfKernel = kernelSize / 2;
-    
-    for (int ky = -halfKernel; ky <= halfKernel; ky++) {
+    int sum = 0;
+    for (int ky = 0; ky < kernelSize; ky++) {
+        const T* row = rows[ky];
+        const int* kernelRow = kernel + ky * kernelSize + halfKernel;
         for (int kx = -halfKernel; kx <= halfKernel; kx++) {
-            int pixelValue = getClampedPixel(image, x + kx, y + ky);
-            int kernelIndex = (ky + halfKernel) * kernelSize + (kx + halfKernel);
-            sum += pixelValue * kernel[kernelIndex];
+            sum += row[static_cast<ptrdiff_t>(src.clampX(x + kx)) * src.step] * kernelRow[kx];
         }
     }
-    
-    if (kernelSum != 0) {
+    return sum;
+}
+
+// Tramo de count muestras de una fila (paso step) convertido a int y contiguo
+template<typename T>
+static void widenSpan(const T* source, int step, int* line, int count) {
+    if (step == 1) {
+        for (int i = 0; i < count; i++) {
+            line[i] = source[i];
+        }
+    } else {
+        for (int i = 0; i < count; i++) {
+            line[i] = source[static_cast<ptrdiff_t>(i) * step];
+        }
+    }
+}
+
+// División, desplazamiento y recorte a [0, maxValue] de una suma
+static inline int finishSample(int sum, int kernelSum, int maxValue, int offset) {
+    if (kernelSum > 1) {
         sum /= kernelSum;
     }
-    
-    return clampValue(sum, 0, image->getMaxValue());
+    sum += offset;
+    return sum < 0 ? 0 : (sum > maxValue ? maxValue : sum);
 }
 
-RGB filter::applyKernelRGB(imagesPPM* image, int x, int y, const int* kernel, int kernelSum) {
-    int sumR = 0, sumG = 0, sumB = 0;
+template<typename T>
+void filter::convolveViewSamples(const imageView& src, const imageView& dst,
+                                 const int* kernel, int kernelSum, int maxValue, int offset) {
     int halfKernel = kernelSize / 2;
-    
-    for (int ky = -halfKernel; ky <= halfKernel; ky++) {
-        for (int kx = -halfKernel; kx <= halfKernel; kx++) {
-            RGB pixel = getClampedPixelRGB(image, x + kx, y + ky);
-            int kernelIndex = (ky + halfKernel) * kernelSize + (kx + halfKernel);
-            int kernelValue = kernel[kernelIndex];
-            
-            sumR += pixel.r * kernelValue;
-            sumG += pixel.g * kernelValue;
-            sumB += pixel.b * kernelValue;
+    int step = src.step;
+    ptrdiff_t outStep = dst.step;
+    std::vector<const T*> rows(kernelSize);
+    // Rectángulo interior: todos los vecinos caen en el buffer (relleno
+    // replicado, vecinos reales o píxeles de otro cuadrante), así que se
+    // recorre sin recortar nada. En el marco de arriba y abajo se recortan
+    // solo los punteros de fila (una vez por fila); en el de la izquierda y la
+    // derecha, las columnas de cada vecino
+    int rowBegin, rowEnd, columnBegin, columnEnd;
+    src.interiorRows(halfKernel, rowBegin, rowEnd);
+    src.interiorColumns(halfKernel, columnBegin, columnEnd);
+    // El interior se acumula coeficiente a coeficiente sobre toda la fila en
+    // lugar de píxel a píxel: cada fila de entrada de la ventana se convierte
+    // una vez a int contiguo (line) y cada coeficiente no nulo es una pasada
+    // vectorial sobre ella (simdStencil::accumulateRow). Con radios grandes
+    // el trabajo por píxel queda en una fracción de instrucción por coeficiente
+    int interiorWidth = columnEnd - columnBegin;
+    std::vector<int> sums(interiorWidth > 0 ? interiorWidth : 1);
+    std::vector<int> line(interiorWidth > 0 ? interiorWidth + 2 * halfKernel : 1);
+
+    for (int y = 0; y < dst.height; y++) {
+        bool interiorRow = y >= rowBegin && y < rowEnd;
+        for (int ky = 0; ky < kernelSize; ky++) {
+            int sourceY = y + ky - halfKernel;
+            rows[ky] = src.row<const T>(interiorRow ? sourceY : src.clampY(sourceY));
+        }
+        T* outRow = dst.row<T>(y);
+
+        for (int x = 0; x < columnBegin; x++) {
+            int sum = convolveClampedSample<T>(src, rows.data(), x, kernel, kernelSize);
+            outRow[x * outStep] = static_cast<T>(finishSample(sum, kernelSum, maxValue, offset));
+        }
+        if (interiorWidth > 0) {
+            std::fill(sums.begin(), sums.end(), 0);
+            for (int ky = 0; ky < kernelSize; ky++) {
+                const int* kernelRow = kernel + ky * kernelSize;
+                bool used = false;
+                for (int kx = 0; kx < kernelSize; kx++) {
+                    used = used || kernelRow[kx] != 0;
+                }
+                if (!used) continue;
+                widenSpan<T>(rows[ky] + static_cast<ptrdiff_t>(columnBegin - halfKernel) * step, step,
+                             line.data(), interiorWidth + 2 * halfKernel);
+                for (int kx = 0; kx < kernelSize; kx++) {
+                    if (kernelRow[kx] != 0) {
+                        simdStencil::accumulateRow(line.data() + kx, kernelRow[kx], sums.data(), interiorWidth);
+                    }
+                }
+            }
+            for (int x = columnBegin; x < columnEnd; x++) {
+                outRow[x * outStep] = static_cast<T>(finishSample(sums[x - columnBegin], kernelSum,
+                                                                  maxValue, offset));
+            }
+        }
+        for (int x = columnEnd; x < dst.width; x++) {
+            int sum = convolveClampedSample<T>(src, rows.data(), x, kernel, kernelSize);
+            outRow[x * outStep] = static_cast<T>(finishSample(sum, kernelSum, maxValue, offset));
         }
     }
-    
-    if (kernelSum != 0) {
-        sumR /= kernelSum;
-        sumG /= kernelSum;
-        sumB /= kernelSum;
-    }
-    
-    return RGB(
-        clampValue(sumR, 0, image->getMaxValue()),
-        clampValue(sumG, 0, image->getMaxValue()),
-        clampValue(sumB, 0, image->getMaxValue())
-    );
-}
\ No newline at end of file
+}
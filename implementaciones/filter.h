@@ -4,6 +4,7 @@
 #include "image.h"
 #include "imagesPGM.h"
 #include "imagesPPM.h"
+#include "imageView.h"
 
 class filter {
 protected:
@@ -18,22 +19,40 @@ public:
     virtual bool applyToPGM(imagesPGM* input, imagesPGM* output) = 0;
     virtual bool applyToPPM(imagesPPM* input, imagesPPM* output) = 0;
 
+    // Kernel aplicado a una vista de un solo canal (imagen completa, región
+    // o filas sueltas con sus vecinas en el halo)
+    virtual void applyToView(const imageView& src, const imageView& dst, int maxValue) = 0;
+
     // Método general que detecta el tipo y aplica el filtro correspondiente
     virtual bool apply(Image* input, Image* output);
+
+    // Modo en flujo: lee inputFile fila a fila, filtra cada fila en cuanto
+    // llegan sus vecinas y la escribe de inmediato en outputFile. En memoria
+    // solo hay un anillo de filas del tamaño del kernel, así que admite
+    // imágenes mayores que la RAM. Mismo resultado que apply + saveToFile
+    bool applyStreaming(const char* inputFile, const char* outputFile);
     
     // Getters
     const char* getName() const { return filterName; }
     int getKernelSize() const { return kernelSize; }
     
 protected:
-    // Métodos auxiliares para manejo de bordes
-    int clampValue(int value, int min, int max);
-    int getClampedPixel(imagesPGM* image, int x, int y);
-    RGB getClampedPixelRGB(imagesPPM* image, int x, int y);
-
-    // Método para aplicar kernel de convolución
-    int applyKernel(imagesPGM* image, int x, int y, const int* kernel, int kernelSum = 1);
-    RGB applyKernelRGB(imagesPPM* image, int x, int y, const int* kernel, int kernelSum = 1);
+    // Convolución de una vista (un solo canal) con bordes por repetición,
+    // para los kernels definidos en tiempo de ejecución (los incluidos usan
+    // fixedKernel). La vista puede ser una región: los vecinos se leen de su
+    // halo y solo se recorta al borde real de la imagen. Recorre las filas de
+    // forma lineal; offset se suma tras dividir por kernelSum, antes de
+    // recortar a [0, maxValue]. Los kernels 3x3 usan SSE2/AVX2/AVX-512 cuando
+    // es posible (ver simdStencil), los separables se detectan solos y van por
+    // dos pasadas (ver separableKernel); el resto despacha a la versión
+    // especializada según el tamaño de muestra (1 o 2 bytes)
+    void convolveView(const imageView& src, const imageView& dst,
+                      const int* kernel, int kernelSum, int maxValue, int offset = 0);
+
+private:
+    template<typename T>
+    void convolveViewSamples(const imageView& src, const imageView& dst,
+                             const int* kernel, int kernelSum, int maxValue, int offset);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "filterPipeline.h"
+#include "bufferPool.h"
+#include "timer.h"
+#include <iostream>
+#include <cstring>
+
+filterPipeline::filterPipeline(filter* filterEngine, int workers)
+    : engine(filterEngine), workerCount(workers < 1 ? 1 : workers),
+      width(0), height(0), channels(0), sampleBytes(0), maxValue(0), radius(0),
+      bandRows(0), bandCount(0), inputBuffer(nullptr), inputPixels(nullptr), inputStride(0),
+      outputPixels(nullptr), rowsRead(0), nextBand(0), failed(false),
+      readMilliseconds(0), filterMilliseconds(0), writeMilliseconds(0) {
+    pthread_mutex_init(&lock, nullptr);
+    pthread_cond_init(&changed, nullptr);
+}
+
+filterPipeline::~filterPipeline() {
+    bufferPool::instance().release(inputBuffer);
+    bufferPool::instance().release(outputPixels);
+    pthread_cond_destroy(&changed);
+    pthread_mutex_destroy(&lock);
+}
+
+// Vistas de los canales de rows filas a partir de la fila y
+void filterPipeline::channelViews(unsigned char* base, int stride, int y, int rows, imageView* views) const {
+    unsigned char* row = base + static_cast<size_t>(y) * stride * sampleBytes;
+    for (int c = 0; c < channels; c++) {
+        views[c] = imageView(row + c * sampleBytes, width, rows, stride, channels, sampleBytes);
+    }
+}
+
+void filterPipeline::replicateColumns(int y, int rows) {
+    imageView views[3];
+    channelViews(inputPixels, inputStride, y, rows, views);
+    for (int c = 0; c < channels; c++) {
+        for (int r = 0; r < rows; r++) {
+            for (int k = 1; k <= radius; k++) {
+                views[c].putSample(-k, r, views[c].sample(0, r));
+                views[c].putSample(width - 1 + k, r, views[c].sample(width - 1, r));
+            }
+        }
+    }
+}
+
+// Copia la fila from (ya con sus columnas replicadas) en la fila to del halo
+void filterPipeline::replicateRow(int from, int to) {
+    size_t rowBytes = static_cast<size_t>(inputStride) * sampleBytes;
+    unsigned char* rowStart = inputPixels - static_cast<size_t>(radius) * channels * sampleBytes;
+    memcpy(rowStart + to * static_cast<ptrdiff_t>(rowBytes), rowStart + from * static_cast<ptrdiff_t>(rowBytes), rowBytes);
+}
+
+void filterPipeline::fail() {
+    pthread_mutex_lock(&lock);
+    failed = true;
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&lock);
+}
+
+// Lee franja a franja y publica cuántas filas están listas
+void filterPipeline::readAll() {
+    timer readTimer;
+    readTimer.start();
+    imageView views[3];
+    for (int y = 0; y < height; y += bandRows) {
+        int rows = y + bandRows <= height ? bandRows : height - y;
+        channelViews(inputPixels, inputStride, y, rows, views);
+        if (!input.readRows(views)) {
+            fail();
+            return;
+        }
+        replicateColumns(y, rows);
+        if (y == 0) {
+            for (int k = 1; k <= radius; k++) replicateRow(0, -k);
+        }
+        if (y + rows == height) {
+            for (int k = 1; k <= radius; k++) replicateRow(height - 1, height - 1 + k);
+        }
+
+        pthread_mutex_lock(&lock);
+        rowsRead = y + rows;
+        pthread_cond_broadcast(&changed);
+        pthread_mutex_unlock(&lock);
+    }
+    readTimer.stop();
+    readMilliseconds = readTimer.getElapsedMilliseconds();
+}
+
+// Cada hilo toma la siguiente franja libre y espera a que estén leídas sus
+// filas más las radius siguientes (o el final de la imagen)
+void filterPipeline::filterBands() {
+    double busy = 0;
+    pthread_mutex_lock(&lock);
+    while (!failed && nextBand < bandCount) {
+        int band = nextBand++;
+        int y = band * bandRows;
+        int rows = y + bandRows <= height ? bandRows : height - y;
+        int needed = y + rows + radius < height ? y + rows + radius : height;
+        while (!failed && rowsRead < needed) {
+            pthread_cond_wait(&changed, &lock);
+        }
+        if (failed) break;
+        pthread_mutex_unlock(&lock);
+
+        timer bandTimer;
+        bandTimer.start();
+        imageView src[3];
+        imageView dst[3];
+        channelViews(inputPixels, inputStride, y, rows, src);
+        channelViews(outputPixels, width * channels, y, rows, dst);
+        for (int c = 0; c < channels; c++) {
+            src[c].haloLeft = src[c].haloTop = src[c].haloRight = src[c].haloBottom = radius;
+            engine->applyToView(src[c], dst[c], maxValue);
+        }
+        bandTimer.stop();
+        busy += bandTimer.getElapsedMilliseconds();
+
+        pthread_mutex_lock(&lock);
+        bandDone[band] = 1;
+        pthread_cond_broadcast(&changed);
+    }
+    filterMilliseconds += busy;
+    pthread_mutex_unlock(&lock);
+}
+
+// Escribe las franjas en orden a medida que se terminan
+bool filterPipeline::writeAll(const char* outputFile) {
+    double busy = 0;
+    imageView views[3];
+    for (int band = 0; band < bandCount; band++) {
+        pthread_mutex_lock(&lock);
+        while (!failed && !bandDone[band]) {
+            pthread_cond_wait(&changed, &lock);
+        }
+        bool stop = failed;
+        pthread_mutex_unlock(&lock);
+        if (stop) return false;
+
+        timer bandTimer;
+        bandTimer.start();
+        int y = band * bandRows;
+        int rows = y + bandRows <= height ? bandRows : height - y;
+        channelViews(outputPixels, width * channels, y, rows, views);
+        if (!output.writeRows(views)) {
+            std::cerr << "Error: No se pudo escribir en " << outputFile << std::endl;
+            fail();
+            return false;
+        }
+        bandTimer.stop();
+        busy += bandTimer.getElapsedMilliseconds();
+    }
+
+    timer closeTimer;
+    closeTimer.start();
+    bool ok = output.finish();
+    closeTimer.stop();
+    writeMilliseconds = busy + closeTimer.getElapsedMilliseconds();
+    if (!ok) {
+        std::cerr << "Error: No se pudo escribir en " << outputFile << std::endl;
+    }
+    return ok;
+}
+
+void* filterPipeline::readerThread(void* arg) {
+    static_cast<filterPipeline*>(arg)->readAll();
+    return nullptr;
+}
+
+void* filterPipeline::workerThread(void* arg) {
+    static_cast<filterPipeline*>(arg)->filterBands();
+    return nullptr;
+}
+
+bool filterPipeline::run(const char* inputFile, const char* outputFile) {
+    if (!input.loadFromFile(inputFile)) {
+        return false;
+    }
+    output.copyHeader(input);
+    if (!output.saveToFile(outputFile)) {
+        return false;
+    }
+
+    width = input.getWidth();
+    height = input.getHeight();
+    channels = input.getChannelCount();
+    sampleBytes = input.getSampleBytes();
+    maxValue = input.getMaxValue();
+    radius = engine->getKernelSize() / 2;
+
+    // Franjas de ~1 MiB de salida, pero al menos 4 por hilo para repartir
+    size_t rowBytes = static_cast<size_t>(width) * channels * sampleBytes;
+    bandRows = static_cast<int>((static_cast<size_t>(1) << 20) / rowBytes);
+    int balancedRows = (height + 4 * workerCount - 1) / (4 * workerCount);
+    if (bandRows > balancedRows) bandRows = balancedRows;
+    if (bandRows < 1) bandRows = 1;
+    bandCount = (height + bandRows - 1) / bandRows;
+    bandDone.assign(bandCount, 0);
+
+    inputStride = (width + 2 * radius) * channels;
+    size_t inputBytes = static_cast<size_t>(height + 2 * radius) * inputStride * sampleBytes;
+    inputBuffer = bufferPool::instance().acquire(inputBytes);
+    inputPixels = inputBuffer + (static_cast<size_t>(radius) * inputStride + radius * channels) * sampleBytes;
+    outputPixels = bufferPool::instance().acquire(static_cast<size_t>(height) * rowBytes);
+
+    std::cout << "Aplicando filtro " << engine->getName() << " en tubería a imagen de "
+              << width << "x" << height << " (" << bandCount << " franjas de " << bandRows
+              << " filas, " << workerCount << " hilo(s) de filtrado)" << std::endl;
+
+    pthread_t reader;
+    std::vector<pthread_t> workers(workerCount);
+    if (pthread_create(&reader, nullptr, readerThread, this) != 0) {
+        std::cerr << "Error: No se pudo crear el hilo lector" << std::endl;
+        return false;
+    }
+    int started = 0;
+    for (; started < workerCount; started++) {
+        if (pthread_create(&workers[started], nullptr, workerThread, this) != 0) {
+            std::cerr << "Error: No se pudo crear el hilo de filtrado " << started << std::endl;
+            fail();
+            break;
+        }
+    }
+
+    bool ok = started == workerCount && writeAll(outputFile);
+
+    pthread_join(reader, nullptr);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], nullptr);
+    }
+    if (!ok || failed) {
+        return false;
+    }
+    std::cout << "Filtro " << engine->getName() << " aplicado en tubería exitosamente" << std::endl;
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef FILTER_PIPELINE_H
+#define FILTER_PIPELINE_H
+
+#include "filter.h"
+#include "imageStream.h"
+#include <pthread.h>
+#include <vector>
+
+// Carga, filtrado y guardado solapados dentro de un mismo trabajo:
+//  - un hilo lector convierte el archivo de entrada en franjas de filas,
+//  - workerCount hilos filtran cada franja en cuanto están leídas sus filas
+//    y las radius filas vecinas de la franja siguiente,
+//  - el hilo que llama a run escribe las franjas terminadas en orden.
+// El tiempo total tiende a max(carga, filtro, guardado) en lugar de su suma.
+// El resultado es el mismo que apply + saveToFile
+class filterPipeline {
+private:
+    filter* engine;
+    int workerCount;
+
+    imageStream input;
+    imageStream output;
+    int width;
+    int height;
+    int channels;
+    int sampleBytes;
+    int maxValue;
+    int radius;
+    int bandRows;
+    int bandCount;
+
+    // Entrada completa con radius filas/columnas replicadas en cada borde
+    // (muestras intercaladas) y salida compacta
+    unsigned char* inputBuffer;
+    unsigned char* inputPixels;
+    int inputStride;
+    unsigned char* outputPixels;
+
+    // Estado compartido, protegido por lock
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int rowsRead;               // Filas ya leídas (con sus bordes replicados)
+    int nextBand;               // Siguiente franja sin asignar a un hilo
+    std::vector<char> bandDone; // Franjas ya filtradas
+    bool failed;
+
+    // Tiempo ocupado de cada etapa (el del filtro sumado entre hilos)
+    double readMilliseconds;
+    double filterMilliseconds;
+    double writeMilliseconds;
+
+    void channelViews(unsigned char* base, int stride, int y, int rows, imageView* views) const;
+    void replicateColumns(int y, int rows);
+    void replicateRow(int from, int to);
+    void fail();
+
+    void readAll();
+    void filterBands();
+    bool writeAll(const char* outputFile);
+
+    static void* readerThread(void* arg);
+    static void* workerThread(void* arg);
+
+public:
+    filterPipeline(filter* engine, int workers);
+    ~filterPipeline();
+
+    bool run(const char* inputFile, const char* outputFile);
+
+    int getWorkerCount() const { return workerCount; }
+    int getBandRows() const { return bandRows; }
+    double getReadMilliseconds() const { return readMilliseconds; }
+    double getFilterMilliseconds() const { return filterMilliseconds; }
+    double getWriteMilliseconds() const { return writeMilliseconds; }
+};
+
+#endif
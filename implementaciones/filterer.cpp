@@ -5,45 +5,40 @@
 #include "Image.h"
 #include "imagesPGM.h"
 #include "imagesPPM.h"
+#include "imageFactory.h"
 #include "Filter.h"
 #include "BlurFilter.h"
 #include "LaplaceFilter.h"
 #include "SharpenFilter.h"
+#include "convolutionFilter.h"
 #include "Timer.h"
+#include "filterPipeline.h"
+#include "simdStencil.h"
+#include "mappedFile.h"
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
 
-Image* createImageFromFile(const char* filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: No se puede abrir el archivo " << filename << std::endl;
-        return nullptr;
-    }
-    
-    char magicNumber[3];
-    file >> magicNumber;
-    file.close();
-    
-    if (strcmp(magicNumber, "P2") == 0) {
-        return new imagesPGM();
-    } else if (strcmp(magicNumber, "P3") == 0) {
-        return new imagesPPM();
-    } else {
-        std::cerr << "Error: Formato no soportado. Número mágico: " << magicNumber << std::endl;
-        return nullptr;
-    }
-}
-
-Image* createOutputImage(Image* input) {
+// La salida comparte cabecera y geometría con la entrada; sus píxeles no se
+// copian porque el filtro los sobrescribe todos
+// Con P5/P6 de 8 bits los píxeles de salida se proyectan sobre outputFile
+// (si no es nullptr): el filtro escribe cada fila en su lugar definitivo de
+// un temporal que al guardar se renombra a outputFile, así que outputFile
+// puede ser el mismo archivo que la entrada proyectada
+Image* createOutputImage(Image* input, const char* outputFile) {
     if (!input) return nullptr;
     
-    if (strcmp(input->getMagicNumber(), "P2") == 0) {
+    if (input->isGrayscale()) {
         imagesPGM* pgmInput = dynamic_cast<imagesPGM*>(input);
         if (pgmInput) {
-            return pgmInput->clone();
+            imagesPGM* mapped = outputFile ? pgmInput->createMappedOutput(outputFile) : nullptr;
+            return mapped ? mapped : pgmInput->createLike();
         }
-    } else if (strcmp(input->getMagicNumber(), "P3") == 0) {
+    } else if (input->isColor()) {
         imagesPPM* ppmInput = dynamic_cast<imagesPPM*>(input);
         if (ppmInput) {
-            return ppmInput->clone();
+            imagesPPM* mapped = outputFile ? ppmInput->createMappedOutput(outputFile) : nullptr;
+            return mapped ? mapped : ppmInput->createLike();
         }
     }
     
@@ -62,21 +57,127 @@ filter* createFilter(const char* filterName) {
     }
 }
 
+// "--f <filtro>" para los filtros incluidos o "--k <kernel>" para un kernel
+// NxN del usuario (archivo o lista de coeficientes, ver convolutionKernel)
+filter* createFilter(const char* filterFlag, const char* filterName) {
+    if (strcmp(filterFlag, "--k") == 0) {
+        convolutionKernel kernel;
+        if (!kernel.load(filterName)) {
+            return nullptr;
+        }
+        return new convolutionFilter(kernel);
+    }
+    filter* filter = createFilter(filterName);
+    if (!filter) {
+        std::cerr << "Error: Filtro no reconocido: " << filterName << std::endl;
+        std::cerr << "Filtros disponibles: blur, laplace, sharpen" << std::endl;
+    }
+    return filter;
+}
+
 void printUsage(const char* programName) {
-    std::cout << "Uso: " << programName << " <entrada> <salida> --f <filtro>" << std::endl;
+    std::cout << "Uso: " << programName << " <entrada> <salida> (--f <filtro> | --k <kernel>) [--stream | --pipeline [hilos] | --region x,y,ancho,alto]" << std::endl;
     std::cout << "Ejemplos:" << std::endl;
     std::cout << "  " << programName << " fruit.ppm fruit_blur.ppm --f blur" << std::endl;
     std::cout << "  " << programName << " lena.pgm lena_laplace.pgm --f laplace" << std::endl;
     std::cout << "  " << programName << " puj.ppm puj_sharpen.ppm --f sharpen" << std::endl;
+    std::cout << "  " << programName << " lena.pgm lena_gauss5.pgm --k gauss5.txt" << std::endl;
+    std::cout << "  " << programName << " lena.pgm lena_box.pgm --k \"1,1,1,1,1,1,1,1,1\"" << std::endl;
     std::cout << std::endl;
     std::cout << "Filtros disponibles:" << std::endl;
     std::cout << "  - blur     : Filtro de suavizado (desenfoque)" << std::endl;
     std::cout << "  - laplace  : Filtro Laplaciano (detección de bordes)" << std::endl;
     std::cout << "  - sharpen  : Filtro de realce (nitidez)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Con --k se aplica un kernel NxN propio (N impar), desde un archivo o como" << std::endl;
+    std::cout << "lista de coeficientes por filas; \"divisor N\" y \"offset N\" son opcionales" << std::endl;
+    std::cout << "(por defecto el divisor es la suma de los coeficientes)" << std::endl;
+    std::cout << "Con --stream la imagen se filtra fila a fila mientras se lee, con" << std::endl;
+    std::cout << "memoria constante (imágenes más grandes que la RAM)" << std::endl;
+    std::cout << "Con --pipeline la carga, el filtrado (por franjas, en varios hilos) y el" << std::endl;
+    std::cout << "guardado se solapan; por defecto un hilo de filtrado por núcleo" << std::endl;
+    std::cout << "Con <salida> terminada en .gz la imagen se guarda comprimida con gzip" << std::endl;
+    std::cout << "Con <salida> terminada en .pnt se guarda como caché en mosaicos, de la que" << std::endl;
+    std::cout << "--region carga y filtra solo una región (leyendo únicamente sus mosaicos)" << std::endl;
+}
+
+// Modo de memoria acotada: ni la entrada ni la salida están enteras en memoria
+int runStreaming(const char* inputFile, const char* outputFile, filter* filter) {
+    // La salida se escribe mientras la entrada aún se está leyendo
+    if (mappedFile::sameFile(inputFile, outputFile)) {
+        std::cerr << "Error: En modo --stream la salida debe ser un archivo distinto de la entrada" << std::endl;
+        delete filter;
+        return 1;
+    }
+
+    std::cout << "Filtro '" << filter->getName() << "' en modo streaming (kernel "
+              << filter->getKernelSize() << "x" << filter->getKernelSize() << ")" << std::endl << std::endl;
+
+    timer totalTimer;
+    totalTimer.start();
+    bool success = filter->applyStreaming(inputFile, outputFile);
+    totalTimer.stop();
+    delete filter;
+
+    if (!success) {
+        std::cerr << "Error: No se pudo aplicar el filtro a " << inputFile << std::endl;
+        return 1;
+    }
+
+    std::cout << std::endl;
+    totalTimer.printDetailedTime("TIEMPO TOTAL DE EJECUCIÓN");
+    std::cout << "\n✓ Procesamiento completado exitosamente" << std::endl;
+    return 0;
+}
+
+// Carga, filtrado y guardado solapados: el total se acerca a la fase más
+// lenta en lugar de a la suma de las tres
+int runPipelined(const char* inputFile, const char* outputFile, filter* filter, int workers) {
+    // La salida se escribe mientras la entrada aún se está leyendo
+    if (mappedFile::sameFile(inputFile, outputFile)) {
+        std::cerr << "Error: En modo --pipeline la salida debe ser un archivo distinto de la entrada" << std::endl;
+        delete filter;
+        return 1;
+    }
+
+    timer totalTimer;
+    totalTimer.start();
+    filterPipeline* pipeline = new filterPipeline(filter, workers);
+    bool success = pipeline->run(inputFile, outputFile);
+    totalTimer.stop();
+
+    if (!success) {
+        std::cerr << "Error: No se pudo aplicar el filtro a " << inputFile << std::endl;
+        delete pipeline;
+        delete filter;
+        return 1;
+    }
+
+    double stages = pipeline->getReadMilliseconds() + pipeline->getFilterMilliseconds() +
+                    pipeline->getWriteMilliseconds();
+    std::cout << std::endl;
+    std::cout << "=== Resumen de Tiempos (etapas solapadas) ===" << std::endl;
+    std::cout << "Carga de imagen: " << pipeline->getReadMilliseconds() << " ms" << std::endl;
+    std::cout << "Aplicación de filtro: " << pipeline->getFilterMilliseconds() << " ms (suma de "
+              << pipeline->getWorkerCount() << " hilo(s))" << std::endl;
+    std::cout << "Guardado de imagen: " << pipeline->getWriteMilliseconds() << " ms" << std::endl;
+    std::cout << "Suma de etapas: " << stages << " ms, total: "
+              << totalTimer.getElapsedMilliseconds() << " ms" << std::endl;
+    totalTimer.printDetailedTime("TIEMPO TOTAL DE EJECUCIÓN");
+
+    delete pipeline;
+    delete filter;
+    bufferPool::instance().printStatistics();
+
+    std::cout << "\n✓ Procesamiento completado exitosamente" << std::endl;
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 5) {
+    bool streaming = argc == 6 && strcmp(argv[5], "--stream") == 0;
+    bool pipelined = (argc == 6 || argc == 7) && strcmp(argv[5], "--pipeline") == 0;
+    bool region = argc == 7 && strcmp(argv[5], "--region") == 0;
+    if (argc != 5 && !streaming && !pipelined && !region) {
         std::cerr << "Error: Número incorrecto de argumentos" << std::endl;
         printUsage(argv[0]);
         return 1;
@@ -87,8 +188,8 @@ int main(int argc, char* argv[]) {
     const char* filterFlag = argv[3];
     const char* filterName = argv[4];
 
-    if (strcmp(filterFlag, "--f") != 0) {
-        std::cerr << "Error: Se esperaba '--f' antes del nombre del filtro" << std::endl;
+    if (strcmp(filterFlag, "--f") != 0 && strcmp(filterFlag, "--k") != 0) {
+        std::cerr << "Error: Se esperaba '--f' o '--k' antes del filtro" << std::endl;
         printUsage(argv[0]);
         return 1;
     }
@@ -98,6 +199,27 @@ int main(int argc, char* argv[]) {
     std::cout << "Archivo de salida: " << outputFile << std::endl;
     std::cout << "Filtro a aplicar: " << filterName << std::endl;
     std::cout << "=========================================" << std::endl << std::endl;
+
+    // El filtro se crea antes de cargar la imagen: el radio de su kernel
+    // decide el relleno
+    filter* filter = createFilter(filterFlag, filterName);
+    if (!filter) {
+        return 1;
+    }
+
+    if (streaming) {
+        return runStreaming(inputFile, outputFile, filter);
+    }
+    if (pipelined) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        int workers = argc == 7 ? atoi(argv[6]) : static_cast<int>(cores > 0 ? cores : 1);
+        if (workers < 1) {
+            std::cerr << "Error: Número de hilos inválido: " << argv[6] << std::endl;
+            delete filter;
+            return 1;
+        }
+        return runPipelined(inputFile, outputFile, filter, workers);
+    }
     
     timer totalTimer;
     totalTimer.start();
@@ -107,15 +229,25 @@ int main(int argc, char* argv[]) {
     timer loadTimer;
     loadTimer.start();
     
-    Image* inputImage = createImageFromFile(inputFile);
-    if (!inputImage) {
-        std::cerr << "Error: No se pudo crear la imagen de entrada" << std::endl;
+    // Relleno replicado del radio del kernel: los filtros leen los vecinos
+    // del borde sin recortar coordenadas. Las entradas P5/P6 de 8 bits se
+    // usan sin copiar desde la proyección del archivo (entonces sin relleno)
+    imageLoadOptions options;
+    options.halo = filter->getKernelSize() / 2;
+    options.memoryMapped = true;
+    // Organización planar: los filtros procesan un canal a la vez (una P6 de
+    // 8 bits proyectada queda intercalada, tal como está en el archivo)
+    options.layout = PPM_PLANAR;
+    if (region && (sscanf(argv[6], "%d,%d,%d,%d", &options.regionX, &options.regionY,
+                          &options.regionWidth, &options.regionHeight) != 4 || options.regionWidth <= 0)) {
+        std::cerr << "Error: Región inválida: " << argv[6] << " (se esperaba x,y,ancho,alto)" << std::endl;
+        delete filter;
         return 1;
     }
-    
-    if (!inputImage->loadFromFile(inputFile)) {
+    Image* inputImage = imageFactory::load(inputFile, options);
+    if (!inputImage) {
         std::cerr << "Error: No se pudo cargar " << inputFile << std::endl;
-        delete inputImage;
+        delete filter;
         return 1;
     }
     
@@ -126,22 +258,20 @@ int main(int argc, char* argv[]) {
     
     // Crear filtro
     std::cout << "2. Inicializando filtro..." << std::endl;
-    filter* filter = createFilter(filterName);
-    if (!filter) {
-        std::cerr << "Error: Filtro no reconocido: " << filterName << std::endl;
-        std::cerr << "Filtros disponibles: blur, laplace, sharpen" << std::endl;
-        delete inputImage;
-        return 1;
-    }
-    
     std::cout << "Filtro '" << filter->getName() << "' inicializado correctamente" << std::endl;
-    std::cout << "Tamaño de kernel: " << filter->getKernelSize() << "x" << filter->getKernelSize() << std::endl << std::endl;
+    std::cout << "Tamaño de kernel: " << filter->getKernelSize() << "x" << filter->getKernelSize() << std::endl;
+    convolutionFilter* custom = dynamic_cast<convolutionFilter*>(filter);
+    if (custom) {
+        std::cout << "Divisor: " << custom->getKernel().getDivisor()
+                  << ", desplazamiento: " << custom->getKernel().getOffset() << std::endl;
+    }
+    std::cout << "Instrucciones vectoriales: " << simdStencil::levelName(simdStencil::level()) << std::endl << std::endl;
     
     // Crear imagen de salida
     std::cout << "3. Creando imagen de salida..." << std::endl;
-    Image* outputImage = createOutputImage(inputImage);
+    Image* outputImage = createOutputImage(inputImage, outputFile);
     if (!outputImage) {
-        std::cerr << "Error: No se pudo crear la imagen de salida" << std::endl;
+        std::cerr << "Error: No se pudo crear la imagen de salida " << outputFile << std::endl;
         delete inputImage;
         delete filter;
         return 1;
@@ -205,6 +335,9 @@ int main(int argc, char* argv[]) {
     delete outputImage;
     delete filter;
     
+    // Los buffers liberados quedan en el pool para el siguiente trabajo
+    bufferPool::instance().printStatistics();
+    
     std::cout << "\n✓ Procesamiento completado exitosamente" << std::endl;
     return 0;
 }
\ No newline at end of file
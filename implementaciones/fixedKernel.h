@@ -0,0 +1,139 @@
+#ifndef FIXED_KERNEL_H
+#define FIXED_KERNEL_H
+
+#include <cstdlib>
+#include "imageView.h"
+#include "simdStencil.h"
+
+// Lado de un kernel cuadrado de count coeficientes (0 si count no es un cuadrado)
+constexpr int fixedKernelSide(int count, int side = 1) {
+    return side * side == count ? side : (side * side > count ? 0 : fixedKernelSide(count, side + 1));
+}
+
+// Término de un coeficiente conocido al compilar: los ceros no leen la muestra
+template<int Coefficient>
+struct fixedKernelTap {
+    template<typename T> static int apply(const T* row, ptrdiff_t position) {
+        return Coefficient * row[position];
+    }
+};
+template<>
+struct fixedKernelTap<0> {
+    template<typename T> static int apply(const T*, ptrdiff_t) {
+        return 0;
+    }
+};
+
+// Suma desenrollada de los coeficientes desde Index (por filas, Size por fila).
+// rows apunta a las Size filas de la ventana; en el interior las columnas son
+// center + (k - radio) * step y en el marco vienen ya recortadas en columns
+template<int Index, int Size, int... Coefficients>
+struct fixedKernelSum {
+    template<typename T> static int interior(const T* const*, ptrdiff_t, ptrdiff_t) { return 0; }
+    template<typename T> static int clamped(const T* const*, const ptrdiff_t*) { return 0; }
+};
+template<int Index, int Size, int Coefficient, int... Rest>
+struct fixedKernelSum<Index, Size, Coefficient, Rest...> {
+    template<typename T> static int interior(const T* const* rows, ptrdiff_t center, ptrdiff_t step) {
+        return fixedKernelTap<Coefficient>::apply(rows[Index / Size], center + (Index % Size - Size / 2) * step) +
+               fixedKernelSum<Index + 1, Size, Rest...>::interior(rows, center, step);
+    }
+    template<typename T> static int clamped(const T* const* rows, const ptrdiff_t* columns) {
+        return fixedKernelTap<Coefficient>::apply(rows[Index / Size], columns[Index % Size]) +
+               fixedKernelSum<Index + 1, Size, Rest...>::clamped(rows, columns);
+    }
+};
+
+// Kernel de convolución con coeficientes, divisor y valor absoluto fijados
+// al compilar (coeficientes por filas). Cada filtro incluido declara su
+// kernel como un tipo (ver builtinKernels.h) y el compilador genera para él
+// un bucle desenrollado: sin lecturas del kernel en memoria, sin trabajo para
+// los coeficientes nulos y con la división por una constante.
+// apply usa primero SSE2/AVX2/AVX-512 (ver simdStencil) y, si no es posible,
+// la versión escalar desenrollada con el interior sin recortar. El resultado
+// es el mismo que filter::convolveView con el kernel equivalente
+template<int Divisor, bool Absolute, int... Coefficients>
+class fixedKernel {
+public:
+    static const int size = fixedKernelSide(sizeof...(Coefficients));
+    static const int radius = size / 2;
+    static const int divisor = Divisor;
+    static const bool absolute = Absolute;
+
+    static_assert(size % 2 == 1, "El kernel debe ser cuadrado y de lado impar");
+    static_assert(Divisor >= 1, "El divisor debe ser positivo");
+
+    // Coeficientes en memoria, para los motores que reciben el kernel como datos
+    static const int* coefficients() {
+        static const int values[] = {Coefficients...};
+        return values;
+    }
+
+    // Bordes por repetición dentro de la zona legible de src, división por
+    // el divisor, valor absoluto opcional y recorte a [0, maxValue]
+    static void apply(const imageView& src, const imageView& dst, int maxValue) {
+        if (size == 3 && simdStencil::convolve3x3(src, dst, coefficients(), Divisor, Absolute, maxValue)) {
+            return;
+        }
+        if (src.sampleBytes == 1) {
+            applySamples<uint8_t>(src, dst, maxValue);
+        } else {
+            applySamples<uint16_t>(src, dst, maxValue);
+        }
+    }
+
+private:
+    typedef fixedKernelSum<0, size, Coefficients...> taps;
+
+    static int finish(int sum, int maxValue) {
+        if (Divisor > 1) sum /= Divisor;
+        if (Absolute) sum = abs(sum);
+        return sum < 0 ? 0 : (sum > maxValue ? maxValue : sum);
+    }
+
+    // Píxel del marco: las columnas vecinas se recortan a la zona legible
+    template<typename T>
+    static int clampedSample(const imageView& src, const T* const* rows, int x, int maxValue) {
+        ptrdiff_t columns[size];
+        for (int k = 0; k < size; k++) {
+            columns[k] = static_cast<ptrdiff_t>(src.clampX(x + k - radius)) * src.step;
+        }
+        return finish(taps::clamped(rows, columns), maxValue);
+    }
+
+    template<typename T>
+    static void applySamples(const imageView& src, const imageView& dst, int maxValue) {
+        ptrdiff_t step = src.step;
+        ptrdiff_t outStep = dst.step;
+        int rowBegin, rowEnd, columnBegin, columnEnd;
+        src.interiorRows(radius, rowBegin, rowEnd);
+        src.interiorColumns(radius, columnBegin, columnEnd);
+        for (int y = 0; y < dst.height; y++) {
+            bool interiorRow = y >= rowBegin && y < rowEnd;
+            const T* rows[size];
+            for (int k = 0; k < size; k++) {
+                rows[k] = src.row<const T>(interiorRow ? y + k - radius : src.clampY(y + k - radius));
+            }
+            T* outRow = dst.row<T>(y);
+            for (int x = 0; x < columnBegin; x++) {
+                outRow[x * outStep] = static_cast<T>(clampedSample<T>(src, rows, x, maxValue));
+            }
+            // Con paso 1 (vista plana) las posiciones son constantes y el
+            // compilador puede vectorizar el bucle
+            if (step == 1) {
+                for (int x = columnBegin; x < columnEnd; x++) {
+                    outRow[x * outStep] = static_cast<T>(finish(taps::interior(rows, x, 1), maxValue));
+                }
+            } else {
+                for (int x = columnBegin; x < columnEnd; x++) {
+                    outRow[x * outStep] = static_cast<T>(finish(taps::interior(rows, x * step, step), maxValue));
+                }
+            }
+            for (int x = columnEnd; x < dst.width; x++) {
+                outRow[x * outStep] = static_cast<T>(clampedSample<T>(src, rows, x, maxValue));
+            }
+        }
+    }
+};
+
+#endif
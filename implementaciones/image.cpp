@@ -1,14 +1,30 @@
 #include "image.h"
+#include "mappedFile.h"
+#include "asciiCodec.h"
+#include "compressedInput.h"
+#include "tiledFormat.h"
 #include <cstring>
 #include <cctype>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#ifdef _OPENMP
+#include <omp.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
-Image::Image() : width(0), height(0), maxValue(0), commentCount(0) {
+Image::Image()
+    : width(0), height(0), maxValue(0), sampleBytes(1), halo(0),
+      mapRequested(false), mapping(nullptr), compressedSource(false), tiledSource(false), commentCount(0) {
     magicNumber = new char[3];
     magicNumber[0] = '\0';
     comments = nullptr;
 }
 
 Image::~Image() {
+    unmapPixels();
     delete[] magicNumber;
     
     if (comments) {
@@ -19,7 +35,7 @@ Image::~Image() {
     }
 }
 
-void Image::skipWhitespace(std::ifstream& file) {
+void Image::skipWhitespace(std::istream& file) {
     char c;
     while (file.get(c) && (c == ' ' || c == '\t' || c == '\n' || c == '\r')) {
     }
@@ -28,32 +44,45 @@ void Image::skipWhitespace(std::ifstream& file) {
     }
 }
 
-void Image::readComments(std::ifstream& file) {
-    char c;
+// Una sola pasada: las líneas de comentario se guardan mientras se leen
+void Image::readComments(std::istream& file) {
+    std::vector<std::string> lines;
     std::string line;
-    std::streampos pos = file.tellg();
-    commentCount = 0;
-    
     while (file.peek() == '#') {
         std::getline(file, line);
-        commentCount++;
+        lines.push_back(line);
     }
 
-    file.seekg(pos);
-    
+    if (comments) {
+        for (int i = 0; i < commentCount; i++) {
+            delete[] comments[i];
+        }
+        delete[] comments;
+        comments = nullptr;
+    }
+    commentCount = static_cast<int>(lines.size());
     if (commentCount > 0) {
         comments = new char*[commentCount];
-        
         for (int i = 0; i < commentCount; i++) {
-            std::getline(file, line);
-            comments[i] = new char[line.length() + 1];
-            strcpy(comments[i], line.c_str());
+            comments[i] = new char[lines[i].length() + 1];
+            strcpy(comments[i], lines[i].c_str());
         }
     }
 }
 
-void Image::parseHeader(std::ifstream& file) {
-    file >> magicNumber;
+bool Image::readMagicNumber(std::istream& file, char* magic, bool* tiled) {
+    magic[0] = '\0';
+    file >> std::setw(3) >> magic;
+    if (tiled) {
+        *tiled = tiledFormat::isTiledMagic(magic);
+        if (*tiled) {
+            file >> std::setw(3) >> magic;
+        }
+    }
+    return magic[0] == 'P' && magic[1] >= '1' && magic[1] <= '6' && magic[2] == '\0';
+}
+
+void Image::parseHeader(std::istream& file) {
     skipWhitespace(file);
     if (file.peek() == '#') {
         readComments(file);
@@ -64,6 +93,62 @@ void Image::parseHeader(std::ifstream& file) {
     file.ignore();
 }
 
+bool Image::loadFromFile(const char* filename) {
+    imageInput input;
+    if (!input.open(filename)) {
+        return false;
+    }
+    if (!readMagicNumber(input.stream(), magicNumber, &tiledSource)) {
+        std::cerr << "Error: Formato no soportado. Número mágico: " << magicNumber << std::endl;
+        return false;
+    }
+    compressedSource = input.isCompressed();
+    return loadFromStream(input.stream(), filename);
+}
+
+bool Image::loadRegionFromStream(std::istream& file, const char* filename, int x, int y, int w, int h) {
+    (void)file;
+    (void)x;
+    (void)y;
+    (void)w;
+    (void)h;
+    std::cerr << "Error: " << filename << " no admite la carga de regiones" << std::endl;
+    return false;
+}
+
+bool Image::parseRegionHeader(std::istream& file, int x, int y, int w, int h, int& fullWidth, int& fullHeight) {
+    if (!tiledSource) {
+        std::cerr << "Error: Las regiones solo se cargan desde cachés en mosaicos (.pnt)" << std::endl;
+        return false;
+    }
+    parseHeader(file);
+    if (!isValidFormat()) {
+        std::cerr << "Error: Formato de archivo inválido" << std::endl;
+        return false;
+    }
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > width || y + h > height) {
+        std::cerr << "Error: La región " << w << "x" << h << " en (" << x << ", " << y
+                  << ") no está dentro de la imagen de " << width << "x" << height << std::endl;
+        return false;
+    }
+    fullWidth = width;
+    fullHeight = height;
+    width = w;
+    height = h;
+    return true;
+}
+
+std::string Image::headerText() const {
+    std::ostringstream header;
+    header << magicNumber << '\n';
+    for (int i = 0; i < commentCount; i++) {
+        header << comments[i] << '\n';
+    }
+    header << width << " " << height << '\n';
+    header << maxValue << '\n';
+    return header.str();
+}
+
 void Image::printComments() const {
     std::cout << "Comentarios encontrados: " << commentCount << std::endl;
     for (int i = 0; i < commentCount; i++) {
@@ -72,6 +157,507 @@ void Image::printComments() const {
 }
 
 bool Image::isValidFormat() const {
-    return (strcmp(magicNumber, "P2") == 0 || strcmp(magicNumber, "P3") == 0) &&
-           width > 0 && height > 0 && maxValue > 0;
-}
\ No newline at end of file
+    return (isGrayscale() || isColor()) &&
+           width > 0 && height > 0 && maxValue > 0 && maxValue <= 65535;
+}
+
+bool Image::isGrayscale() const {
+    return strcmp(magicNumber, "P2") == 0 || strcmp(magicNumber, "P5") == 0;
+}
+
+bool Image::isColor() const {
+    return strcmp(magicNumber, "P3") == 0 || strcmp(magicNumber, "P6") == 0;
+}
+
+bool Image::isBinary() const {
+    return strcmp(magicNumber, "P5") == 0 || strcmp(magicNumber, "P6") == 0;
+}
+
+void Image::setBinary(bool binary) {
+    if (isGrayscale()) {
+        strcpy(magicNumber, binary ? "P5" : "P2");
+    } else if (isColor()) {
+        strcpy(magicNumber, binary ? "P6" : "P3");
+    }
+}
+
+void Image::setHalo(int haloWidth) {
+    if (width > 0) {
+        std::cerr << "Advertencia: El relleno de una imagen cargada no se puede cambiar" << std::endl;
+        return;
+    }
+    halo = haloWidth < 0 ? 0 : haloWidth;
+}
+
+void Image::paddedRowLayout(int samplesPerPixel, int& leftPad, int& rowStride) const {
+    if (halo == 0) {
+        leftPad = 0;
+        rowStride = samplesPerPixel * width;
+        return;
+    }
+    // Muestras por bloque alineado (64 bytes = 64 muestras de 8 bits o 32 de 16)
+    int alignSamples = BUFFER_ALIGNMENT / sampleBytes;
+    int haloSamples = samplesPerPixel * halo;
+    leftPad = (haloSamples + alignSamples - 1) / alignSamples * alignSamples;
+    int used = leftPad + samplesPerPixel * width + haloSamples;
+    rowStride = (used + alignSamples - 1) / alignSamples * alignSamples;
+}
+
+unsigned char* Image::mapPixels(const char* filename, std::streamoff offset, int samplesPerPixel) {
+    unmapPixels();
+    mappedFile* file = new mappedFile();
+    if (!file->open(filename)) {
+        delete file;
+        return nullptr;
+    }
+
+    size_t bytes = static_cast<size_t>(width) * height * samplesPerPixel;
+    if (offset < 0 || file->getSize() < static_cast<size_t>(offset) + bytes) {
+        std::cerr << "Error: No se pudieron leer todos los píxeles" << std::endl;
+        delete file;
+        return nullptr;
+    }
+
+    unsigned char* data = file->getData() + offset;
+    // Con maxValue 255 cualquier byte es válido y no hace falta recorrer el archivo
+    if (maxValue < 255) {
+        for (size_t i = 0; i < bytes; i++) {
+            if (data[i] > maxValue) {
+                std::cerr << "Error: Valor de píxel fuera de rango: " << static_cast<int>(data[i]) << std::endl;
+                delete file;
+                return nullptr;
+            }
+        }
+    }
+
+    file->adviseSequential();
+    mapping = file;
+    sampleBytes = 1;
+    halo = 0;
+    return data;
+}
+
+unsigned char* Image::mapOutputPixels(const char* filename, int samplesPerPixel) {
+    unmapPixels();
+    std::string header = headerText();
+    size_t bytes = static_cast<size_t>(width) * height * samplesPerPixel;
+    mappedFile* file = new mappedFile();
+    if (!file->create(filename, header.size() + bytes)) {
+        delete file;
+        return nullptr;
+    }
+
+    memcpy(file->getData(), header.data(), header.size());
+    mapping = file;
+    sampleBytes = 1;
+    halo = 0;
+    return file->getData() + header.size();
+}
+
+bool Image::isMappedOutput(const char* filename) const {
+    return mapping && mapping->isShared() && strcmp(mapping->getFilename(), filename) == 0;
+}
+
+bool Image::commitMappedOutput() {
+    return mapping && mapping->commit();
+}
+
+void Image::unmapPixels() {
+    delete mapping;
+    mapping = nullptr;
+}
+
+template<typename T>
+static void replicateHaloSamples(const imageView& channel, int halo) {
+    int w = channel.width;
+    int step = channel.step;
+    // Columnas: cada fila repite su primera y su última muestra
+    for (int y = 0; y < channel.height; y++) {
+        T* row = channel.row<T>(y);
+        for (int k = 1; k <= halo; k++) {
+            row[-k * step] = row[0];
+            row[(w - 1 + k) * step] = row[(w - 1) * step];
+        }
+    }
+    // Filas: copia de la primera y la última fila, incluidas sus columnas de relleno
+    const T* first = channel.row<T>(0);
+    const T* last = channel.row<T>(channel.height - 1);
+    for (int k = 1; k <= halo; k++) {
+        T* above = channel.row<T>(-k);
+        T* below = channel.row<T>(channel.height - 1 + k);
+        for (int x = -halo; x < w + halo; x++) {
+            above[x * step] = first[x * step];
+            below[x * step] = last[x * step];
+        }
+    }
+}
+
+void Image::replicateHalo(const imageView& channel, int halo) {
+    if (halo <= 0 || !channel.isValid()) return;
+    if (channel.sampleBytes == 1) {
+        replicateHaloSamples<uint8_t>(channel, halo);
+    } else {
+        replicateHaloSamples<uint16_t>(channel, halo);
+    }
+}
+
+void Image::copyHeaderFrom(const Image& other) {
+    strcpy(magicNumber, other.magicNumber);
+    width = other.width;
+    height = other.height;
+    maxValue = other.maxValue;
+    sampleBytes = other.sampleBytes;
+    halo = other.halo;
+    commentCount = other.commentCount;
+    if (other.commentCount > 0) {
+        comments = new char*[other.commentCount];
+        for (int i = 0; i < other.commentCount; i++) {
+            int len = strlen(other.comments[i]);
+            comments[i] = new char[len + 1];
+            strcpy(comments[i], other.comments[i]);
+        }
+    }
+}
+
+void Image::firstTouch(unsigned char* buffer, size_t bytes) {
+#ifdef _OPENMP
+    // Reparto estático por bloques contiguos, igual que los bucles de filtrado
+    const long pageSize = 4096;
+    long pages = static_cast<long>((bytes + pageSize - 1) / pageSize);
+    #pragma omp parallel for schedule(static)
+    for (long page = 0; page < pages; page++) {
+        buffer[page * pageSize] = 0;
+    }
+#else
+    // Sin OpenMP las páginas se asignan en el primer uso del filtro
+    (void)buffer;
+    (void)bytes;
+#endif
+}
+
+// Las muestras de cada fila están en memoria exactamente como en el archivo
+// (un solo canal o canales intercalados en un mismo buffer)
+static bool isContiguousRow(const imageView* channels, int channelCount) {
+    if (channels[0].step != channelCount) return false;
+    for (int c = 1; c < channelCount; c++) {
+        if (channels[c].data != channels[0].data + c * channels[0].sampleBytes ||
+            channels[c].stride != channels[0].stride) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Image::readBinaryPixels(std::istream& file, const imageView* channels, int channelCount, int maxValue) {
+    int width = channels[0].width;
+    int height = channels[0].height;
+    int sampleBytes = channels[0].sampleBytes;
+    size_t samplesPerRow = static_cast<size_t>(width) * channelCount;
+    size_t rowBytes = samplesPerRow * sampleBytes;
+    bool contiguous = isContiguousRow(channels, channelCount);
+    std::vector<unsigned char> rowBuffer(contiguous ? 0 : rowBytes);
+
+    for (int y = 0; y < height; y++) {
+        // Fila leída directamente en la imagen cuando la organización coincide
+        unsigned char* raw = contiguous ? channels[0].row<unsigned char>(0) +
+                                          static_cast<size_t>(y) * channels[0].stride * sampleBytes
+                                        : rowBuffer.data();
+        if (!file.read(reinterpret_cast<char*>(raw), rowBytes)) {
+            std::cerr << "Error: No se pudieron leer todos los píxeles" << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < samplesPerRow; i++) {
+            int value = (sampleBytes == 1) ? raw[i] : ((raw[2 * i] << 8) | raw[2 * i + 1]);
+            if (value > maxValue) {
+                std::cerr << "Error: Valor de píxel fuera de rango: " << value << std::endl;
+                return false;
+            }
+            if (contiguous) {
+                // Big-endian a orden de la máquina, en el mismo lugar
+                if (sampleBytes == 2) reinterpret_cast<uint16_t*>(raw)[i] = static_cast<uint16_t>(value);
+            } else {
+                channels[i % channelCount].putSample(static_cast<int>(i / channelCount), y, value);
+            }
+        }
+    }
+    return true;
+}
+
+bool Image::writeBinaryPixels(std::ostream& file, const imageView* channels, int channelCount) {
+    int width = channels[0].width;
+    int height = channels[0].height;
+    int sampleBytes = channels[0].sampleBytes;
+    size_t samplesPerRow = static_cast<size_t>(width) * channelCount;
+    size_t rowBytes = samplesPerRow * sampleBytes;
+    bool direct = sampleBytes == 1 && isContiguousRow(channels, channelCount);
+    std::vector<unsigned char> rowBuffer(direct ? 0 : rowBytes);
+
+    for (int y = 0; y < height; y++) {
+        const unsigned char* raw;
+        if (direct) {
+            // 8 bits con la misma organización que el archivo: se escribe la fila tal cual
+            raw = channels[0].row<unsigned char>(0) + static_cast<size_t>(y) * channels[0].stride;
+        } else {
+            for (size_t i = 0; i < samplesPerRow; i++) {
+                int value = channels[i % channelCount].sample(static_cast<int>(i / channelCount), y);
+                if (sampleBytes == 1) {
+                    rowBuffer[i] = static_cast<unsigned char>(value);
+                } else {
+                    rowBuffer[2 * i] = static_cast<unsigned char>(value >> 8);
+                    rowBuffer[2 * i + 1] = static_cast<unsigned char>(value & 0xFF);
+                }
+            }
+            raw = rowBuffer.data();
+        }
+        if (!file.write(reinterpret_cast<const char*>(raw), rowBytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// El cuerpo se lee en bloques de 1 MiB, así la memoria extra es constante
+template<typename T>
+static bool parseAsciiSamples(std::istream& file, const imageView* channels, int channelCount,
+                              int maxValue, size_t total, size_t position) {
+    const size_t BLOCK_BYTES = static_cast<size_t>(1) << 20;
+    std::vector<char> block(BLOCK_BYTES);
+    asciiParser<T> parser(channels, channelCount, maxValue, 0, total);
+
+    while (!parser.isComplete() && !parser.failed() &&
+           file.read(block.data(), block.size()).gcount() > 0) {
+        size_t got = static_cast<size_t>(file.gcount());
+        parser.feed(block.data(), block.data() + got, position);
+        position += got;
+    }
+    parser.finish();
+    if (parser.failed()) {
+        parser.error.report();
+        return false;
+    }
+    if (!parser.isComplete()) {
+        std::cerr << "Error: No se pudieron leer todos los píxeles" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+#ifdef _OPENMP
+// Números (secuencias de dígitos) en [p, end)
+static size_t countAsciiTokens(const char* p, const char* end) {
+    size_t count = 0;
+    bool previousDigit = false;
+    for (; p < end; p++) {
+        bool digit = static_cast<unsigned>(static_cast<unsigned char>(*p) - '0') < 10;
+        count += digit && !previousDigit;
+        previousDigit = digit;
+    }
+    return count;
+}
+
+// Análisis paralelo del cuerpo completo (ya en memoria). Se corta en tramos
+// que terminan en un espacio, así ningún número queda partido; se cuentan los
+// números de cada tramo, la suma prefija da la muestra donde empieza cada uno
+// y todos los tramos se convierten a la vez. Entre los errores de los tramos
+// se informa el de menor posición, el mismo que encontraría la versión secuencial
+template<typename T>
+static bool parseAsciiSamplesParallel(const std::vector<char>& body, const imageView* channels,
+                                      int channelCount, int maxValue, size_t total, size_t position) {
+    const char* text = body.data();
+    size_t size = body.size();
+    int chunks = 4 * omp_get_max_threads();
+
+    std::vector<size_t> bounds(chunks + 1);
+    bounds[0] = 0;
+    bounds[chunks] = size;
+    for (int i = 1; i < chunks; i++) {
+        size_t b = size / chunks * i;
+        if (b < bounds[i - 1]) b = bounds[i - 1];
+        while (b < size && !isAsciiSpace(text[b])) b++;
+        bounds[i] = b;
+    }
+
+    std::vector<size_t> counts(chunks);
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < chunks; i++) {
+        counts[i] = countAsciiTokens(text + bounds[i], text + bounds[i + 1]);
+    }
+
+    std::vector<size_t> firstSample(chunks);
+    size_t found = 0;
+    for (int i = 0; i < chunks; i++) {
+        firstSample[i] = found;
+        found += counts[i];
+    }
+
+    // Los tramos sin números también se recorren: solo pueden tener espacios.
+    // Los que empiezan con la imagen ya completa se ignoran, como el resto
+    // del archivo en la versión secuencial
+    std::vector<asciiError> errors(chunks);
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < chunks; i++) {
+        if (firstSample[i] >= total) continue;
+        size_t samples = counts[i] < total - firstSample[i] ? counts[i] : total - firstSample[i];
+        asciiParser<T> parser(channels, channelCount, maxValue, firstSample[i], samples);
+        const char* begin = text + bounds[i];
+        const char* end = text + bounds[i + 1];
+        const char* rest = parser.feed(begin, end, position + bounds[i]);
+        parser.finish();
+        if (firstSample[i] + samples < total) {
+            parser.expectSpaces(rest, end, position + (rest - text));
+        }
+        errors[i] = parser.error;
+    }
+
+    for (int i = 0; i < chunks; i++) {
+        if (errors[i].type != asciiError::NONE) {
+            errors[i].report();
+            return false;
+        }
+    }
+    if (found < total) {
+        std::cerr << "Error: No se pudieron leer todos los píxeles" << std::endl;
+        return false;
+    }
+    return true;
+}
+#endif
+
+template<typename T>
+static bool readAsciiSamples(std::istream& file, const imageView* channels, int channelCount, int maxValue) {
+    size_t total = static_cast<size_t>(channels[0].width) * channels[0].height * channelCount;
+    std::streamoff start = file.tellg();
+#ifdef _OPENMP
+    // Con varios hilos y un cuerpo grande se lee entero y se analiza en paralelo
+    const std::streamoff PARALLEL_MIN_BYTES = static_cast<std::streamoff>(1) << 20;
+    if (start >= 0 && omp_get_max_threads() > 1) {
+        file.seekg(0, std::ios::end);
+        std::streamoff size = file ? static_cast<std::streamoff>(file.tellg()) - start : 0;
+        file.clear();
+        file.seekg(start);
+        if (size >= PARALLEL_MIN_BYTES) {
+            std::vector<char> body(static_cast<size_t>(size));
+            if (file.read(body.data(), size)) {
+                return parseAsciiSamplesParallel<T>(body, channels, channelCount, maxValue,
+                                                    total, static_cast<size_t>(start));
+            }
+            file.clear();
+            file.seekg(start);
+        }
+    }
+#endif
+    return parseAsciiSamples<T>(file, channels, channelCount, maxValue, total,
+                                start >= 0 ? static_cast<size_t>(start) : 0);
+}
+
+bool Image::readAsciiPixels(std::istream& file, const imageView* channels, int channelCount, int maxValue) {
+    return channels[0].sampleBytes == 1
+        ? readAsciiSamples<uint8_t>(file, channels, channelCount, maxValue)
+        : readAsciiSamples<uint16_t>(file, channels, channelCount, maxValue);
+}
+
+// Las filas se formatean en un buffer de 1 MiB (o de una fila, si es más
+// larga) que se vuelca con write cuando se llena
+template<typename T>
+static bool formatAsciiSamples(std::ostream& file, const imageView* channels, int channelCount) {
+    size_t rowMax = static_cast<size_t>(channels[0].width) * channelCount * MAX_SAMPLE_CHARS;
+    size_t blockBytes = std::max(static_cast<size_t>(1) << 20, rowMax);
+    std::vector<char> block(blockBytes);
+    char* const begin = block.data();
+    char* const limit = begin + blockBytes - rowMax;
+    char* out = begin;
+
+    for (int y = 0; y < channels[0].height; y++) {
+        if (out > limit) {
+            if (!file.write(begin, out - begin)) return false;
+            out = begin;
+        }
+        out = formatAsciiRow<T>(out, channels, channelCount, y);
+    }
+    return static_cast<bool>(file.write(begin, out - begin));
+}
+
+#ifdef _OPENMP
+// pwrite completo (repite las escrituras parciales)
+static bool writeAt(int fd, const char* data, size_t bytes, size_t position) {
+    while (bytes > 0) {
+        ssize_t written = pwrite(fd, data, bytes, static_cast<off_t>(position));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        bytes -= static_cast<size_t>(written);
+        position += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Por rondas: cada hilo formatea una franja de filas consecutivas en su
+// propio buffer (unos 4 MiB de texto); la suma prefija de las longitudes da
+// la posición de cada franja en el archivo y todas se escriben a la vez con
+// pwrite. La memoria extra queda en un buffer por hilo
+template<typename T>
+static bool formatAsciiSamplesParallel(int fd, size_t position, const imageView* channels, int channelCount) {
+    const size_t BAND_BYTES = static_cast<size_t>(4) << 20;
+    int height = channels[0].height;
+    int threads = omp_get_max_threads();
+    size_t rowMax = static_cast<size_t>(channels[0].width) * channelCount * MAX_SAMPLE_CHARS;
+    int bandRows = static_cast<int>(std::max(static_cast<size_t>(1), BAND_BYTES / rowMax));
+
+    std::vector<std::vector<char> > buffers(threads);
+    std::vector<size_t> lengths(threads);
+    std::vector<size_t> offsets(threads);
+    for (int roundStart = 0; roundStart < height; roundStart += bandRows * threads) {
+        #pragma omp parallel for schedule(static, 1)
+        for (int t = 0; t < threads; t++) {
+            int first = roundStart + t * bandRows;
+            int last = std::min(first + bandRows, height);
+            lengths[t] = 0;
+            if (first >= last) continue;
+            buffers[t].resize(static_cast<size_t>(last - first) * rowMax);
+            char* out = buffers[t].data();
+            for (int y = first; y < last; y++) {
+                out = formatAsciiRow<T>(out, channels, channelCount, y);
+            }
+            lengths[t] = static_cast<size_t>(out - buffers[t].data());
+        }
+
+        for (int t = 0; t < threads; t++) {
+            offsets[t] = position;
+            position += lengths[t];
+        }
+
+        bool ok = true;
+        #pragma omp parallel for schedule(static, 1) reduction(&&:ok)
+        for (int t = 0; t < threads; t++) {
+            ok = writeAt(fd, buffers[t].data(), lengths[t], offsets[t]) && ok;
+        }
+        if (!ok) return false;
+    }
+    return true;
+}
+#endif
+
+bool Image::writeAsciiPixels(std::ostream& file, const imageView* channels, int channelCount, const char* filename) {
+    bool wide = channels[0].sampleBytes == 2;
+#ifdef _OPENMP
+    // Imágenes grandes con varios hilos: el texto continúa en el archivo
+    // filename justo después de lo ya escrito en file (la cabecera)
+    const size_t PARALLEL_MIN_SAMPLES = static_cast<size_t>(1) << 18;
+    size_t samples = static_cast<size_t>(channels[0].width) * channels[0].height * channelCount;
+    if (filename && omp_get_max_threads() > 1 && samples >= PARALLEL_MIN_SAMPLES && file.flush()) {
+        std::streamoff position = file.tellp();
+        int fd = position >= 0 ? open(filename, O_WRONLY) : -1;
+        if (fd >= 0) {
+            bool ok = wide ? formatAsciiSamplesParallel<uint16_t>(fd, static_cast<size_t>(position), channels, channelCount)
+                           : formatAsciiSamplesParallel<uint8_t>(fd, static_cast<size_t>(position), channels, channelCount);
+            return close(fd) == 0 && ok;
+        }
+    }
+#else
+    (void)filename;
+#endif
+    return wide ? formatAsciiSamples<uint16_t>(file, channels, channelCount)
+                : formatAsciiSamples<uint8_t>(file, channels, channelCount);
+}
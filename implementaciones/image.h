@@ -5,19 +5,100 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <cstdint>
+#include <cstddef>
+#include "imageView.h"
+#include "bufferPool.h"
+
+class mappedFile;
+class imageFactory;
+class imageInput;
 
 class Image {
+    // Completa el número mágico que ya leyó antes de elegir la clase
+    friend class imageFactory;
+
 protected:
     char* magicNumber;
     int width;
     int height;
     int maxValue;
+    int sampleBytes;   // Bytes por muestra en memoria: 1 (uint8_t) o 2 (uint16_t)
+    int halo;          // Píxeles de relleno replicado en cada borde (0 = sin relleno)
+    bool mapRequested; // Usar los píxeles del archivo proyectado cuando sea posible
+    mappedFile* mapping; // Proyección que contiene los píxeles (nullptr si están en un buffer)
+    bool compressedSource; // Cargada desde un archivo gzip: no hay bytes que proyectar
+    bool tiledSource;      // Cargada desde una caché en mosaicos (.pnt, ver tiledFormat)
     char** comments;
     int commentCount;
     
-    void skipWhitespace(std::ifstream& file);
-    void readComments(std::ifstream& file);
-    void parseHeader(std::ifstream& file);
+    void skipWhitespace(std::istream& file);
+    void readComments(std::istream& file);
+    // Resto de la cabecera tras el número mágico (ya leído en magicNumber):
+    // comentarios, dimensiones y maxValue
+    void parseHeader(std::istream& file);
+
+    // Las filas empiezan en múltiplos de BUFFER_ALIGNMENT bytes
+    static const int BUFFER_ALIGNMENT = static_cast<int>(bufferPool::ALIGNMENT);
+
+    // Geometría de una fila de samplesPerPixel muestras por píxel: muestras
+    // antes de la columna 0 (leftPad) y distancia entre filas (rowStride).
+    // Con halo ambas quedan alineadas; sin halo la fila queda compacta
+    void paddedRowLayout(int samplesPerPixel, int& leftPad, int& rowStride) const;
+
+    // Buffers de píxeles alineados, reciclados a través del pool compartido
+    static unsigned char* acquireBuffer(size_t bytes) { return bufferPool::instance().acquire(bytes); }
+    static void releaseBuffer(unsigned char* buffer) { bufferPool::instance().release(buffer); }
+
+    // Copia los bordes de la vista en las halo columnas/filas que la rodean
+    static void replicateHalo(const imageView& channel, int halo);
+
+    // Muestras binarias (P5/P6): filas de width píxeles con channelCount
+    // muestras intercaladas, de 1 byte o de 2 bytes big-endian. Cada canal se
+    // describe con una vista, así sirven para PGM y para PPM intercalado o planar
+    static bool readBinaryPixels(std::istream& file, const imageView* channels, int channelCount, int maxValue);
+    static bool writeBinaryPixels(std::ostream& file, const imageView* channels, int channelCount);
+    // Muestras ASCII (P2/P3) en el mismo orden, con validación contra maxValue
+    static bool readAsciiPixels(std::istream& file, const imageView* channels, int channelCount, int maxValue);
+    // Con OpenMP y filename (el archivo abierto en file), las filas se
+    // formatean en paralelo y se escriben con pwrite tras lo ya escrito
+    static bool writeAsciiPixels(std::ostream& file, const imageView* channels, int channelCount,
+                                 const char* filename = nullptr);
+
+    // Proyección posible: pedida con setMemoryMapped, archivo binario de 8 bits
+    // sin comprimir ni en mosaicos
+    bool canMapPixels() const {
+        return mapRequested && !compressedSource && !tiledSource && isBinary() && sampleBytesFor(maxValue) == 1;
+    }
+    // Proyecta el archivo y devuelve sus píxeles (samplesPerPixel muestras por
+    // píxel a partir de offset, filas compactas). La imagen queda sin relleno.
+    // nullptr si el archivo está incompleto o algún valor supera maxValue
+    unsigned char* mapPixels(const char* filename, std::streamoff offset, int samplesPerPixel);
+    // Crea un temporal junto a filename con la cabecera y el tamaño final y
+    // devuelve la zona de píxeles dentro de la proyección (filas compactas de
+    // 8 bits, sin relleno)
+    unsigned char* mapOutputPixels(const char* filename, int samplesPerPixel);
+    // Los píxeles ya son el contenido de filename: guardar no tiene que escribir nada
+    bool isMappedOutput(const char* filename) const;
+    // Renombra el temporal de mapOutputPixels a su destino
+    bool commitMappedOutput();
+    void unmapPixels();
+
+    // Cabecera de loadRegionFromStream: lee y valida la cabecera PNM y que la
+    // región [x, x + w) x [y, y + h) esté dentro de la imagen, cuyas
+    // dimensiones completas devuelve en fullWidth/fullHeight; la imagen
+    // queda con las dimensiones de la región
+    bool parseRegionHeader(std::istream& file, int x, int y, int w, int h, int& fullWidth, int& fullHeight);
+
+    // Cabecera PNM tal como se guarda: número mágico, comentarios, dimensiones, maxValue
+    std::string headerText() const;
+
+    // Copia solo la cabecera (tipo, dimensiones, maxValue, relleno, comentarios)
+    void copyHeaderFrom(const Image& other);
+
+    // Primer acceso en paralelo a las páginas de un buffer recién reservado,
+    // para que cada hilo las tenga en su nodo de memoria (solo con OpenMP)
+    static void firstTouch(unsigned char* buffer, size_t bytes);
     
 public:
     Image();
@@ -26,12 +107,54 @@ public:
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     int getMaxValue() const { return maxValue; }
+    int getSampleBytes() const { return sampleBytes; }
+    int getHalo() const { return halo; }
     char* getMagicNumber() const { return magicNumber; }
-    virtual bool loadFromFile(const char* filename) = 0;
+    // Abre filename una sola vez, lee el número mágico y sigue con
+    // loadFromStream. Los archivos gzip se descomprimen mientras se leen
+    virtual bool loadFromFile(const char* filename);
+    // Carga desde file, justo después del número mágico (ya guardado con
+    // readMagicNumber). filename sirve para los mensajes y para proyectar los píxeles
+    virtual bool loadFromStream(std::istream& file, const char* filename) = 0;
+
+    // Solo la región [x, x + w) x [y, y + h) de una caché en mosaicos (.pnt),
+    // con su halo tomado de los píxeles vecinos reales: filtrar la región da
+    // lo mismo que recortar la imagen completa filtrada. Solo se leen los
+    // mosaicos que la tocan. Como loadFromStream, con file después del número
+    // mágico de la imagen; se usa a través de imageFactory::load
+    virtual bool loadRegionFromStream(std::istream& file, const char* filename, int x, int y, int w, int h);
     virtual bool saveToFile(const char* filename) = 0;
     virtual void displayInfo() const = 0;
+
+    // El relleno se elige antes de cargar (normalmente el radio del kernel)
+    void setHalo(int haloWidth);
+    // Vuelve a replicar los bordes; necesario tras modificar los píxeles
+    virtual void fillHalo() = 0;
     void printComments() const;
     bool isValidFormat() const;
+
+    // Tipo según el número mágico: P2/P5 escala de grises, P3/P6 color;
+    // P5/P6 guardan las muestras en binario
+    bool isGrayscale() const;
+    bool isColor() const;
+    bool isBinary() const;
+    // Cambia entre la variante ASCII y la binaria del mismo tipo (al guardar)
+    void setBinary(bool binary);
+
+    // Con P5/P6 de 8 bits los píxeles se leen directamente de una proyección
+    // del archivo (mmap) en lugar de copiarse, y la imagen queda sin relleno:
+    // los filtros recortan las coordenadas del borde. Se elige antes de cargar.
+    // Una PPM proyectada queda intercalada aunque se haya pedido la organización planar
+    void setMemoryMapped(bool enabled) { mapRequested = enabled; }
+    bool isMemoryMapped() const { return mapping != nullptr; }
+
+    // Lee el número mágico ("P1".."P6") en magic (3 caracteres); false si no lo es.
+    // Con tiled, una caché en mosaicos ("PT") pone *tiled en true y magic
+    // recibe el número mágico de la imagen guardada en ella
+    static bool readMagicNumber(std::istream& file, char* magic, bool* tiled = nullptr);
+
+    // Muestras de 8 bits si maxValue <= 255, de 16 bits hasta 65535
+    static int sampleBytesFor(int maxValue) { return maxValue <= 255 ? 1 : 2; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "imageFactory.h"
+#include "compressedInput.h"
+#include <iostream>
+#include <cstring>
+
+Image* imageFactory::create(const char* magicNumber, const imageLoadOptions& options) {
+    Image* image = nullptr;
+    if (strcmp(magicNumber, "P2") == 0 || strcmp(magicNumber, "P5") == 0) {
+        image = new imagesPGM();
+    } else if (strcmp(magicNumber, "P3") == 0 || strcmp(magicNumber, "P6") == 0) {
+        image = new imagesPPM(options.layout);
+    } else {
+        return nullptr;
+    }
+    image->setHalo(options.halo);
+    image->setMemoryMapped(options.memoryMapped);
+    return image;
+}
+
+Image* imageFactory::load(const char* filename, const imageLoadOptions& options) {
+    imageInput input;
+    if (!input.open(filename)) {
+        return nullptr;
+    }
+
+    char magicNumber[3];
+    bool tiled = false;
+    Image* image = Image::readMagicNumber(input.stream(), magicNumber, &tiled) ? create(magicNumber, options) : nullptr;
+    if (!image) {
+        std::cerr << "Error: Formato no soportado. Número mágico: " << magicNumber << std::endl;
+        return nullptr;
+    }
+
+    // El número mágico ya leído se guarda en la imagen y la carga sigue
+    // desde la posición actual del archivo
+    strcpy(image->magicNumber, magicNumber);
+    image->compressedSource = input.isCompressed();
+    image->tiledSource = tiled;
+    bool loaded = options.regionWidth > 0
+        ? image->loadRegionFromStream(input.stream(), filename, options.regionX, options.regionY,
+                                      options.regionWidth, options.regionHeight)
+        : image->loadFromStream(input.stream(), filename);
+    if (!loaded) {
+        delete image;
+        return nullptr;
+    }
+    return image;
+}
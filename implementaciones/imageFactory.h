@@ -0,0 +1,39 @@
+#ifndef IMAGE_FACTORY_H
+#define IMAGE_FACTORY_H
+
+#include "image.h"
+#include "imagesPGM.h"
+#include "imagesPPM.h"
+
+// Opciones que se fijan antes de cargar (ver Image::setHalo,
+// Image::setMemoryMapped e imagesPPM::setLayout). Con regionWidth > 0 solo
+// se carga esa región de una caché en mosaicos (ver Image::loadRegionFromStream)
+struct imageLoadOptions {
+    int halo;
+    bool memoryMapped;
+    ppmLayout layout;
+    int regionX;
+    int regionY;
+    int regionWidth;
+    int regionHeight;
+
+    imageLoadOptions()
+        : halo(0), memoryMapped(false), layout(PPM_INTERLEAVED),
+          regionX(0), regionY(0), regionWidth(0), regionHeight(0) {}
+};
+
+// Cargador común de los programas: abre el archivo una sola vez, elige la
+// clase según el número mágico leído del propio flujo y continúa la carga
+// sobre el mismo archivo abierto, sin volver a abrirlo ni a buscar el inicio.
+// Los archivos gzip (.pgm.gz, .ppm.gz) se descomprimen mientras se analizan
+// y las cachés en mosaicos (.pnt) se reconocen por su número mágico
+class imageFactory {
+public:
+    // Imagen vacía del tipo indicado por magicNumber; nullptr si no se admite
+    static Image* create(const char* magicNumber, const imageLoadOptions& options);
+
+    // Imagen completamente cargada; nullptr (con el mensaje de error) si falla
+    static Image* load(const char* filename, const imageLoadOptions& options = imageLoadOptions());
+};
+
+#endif
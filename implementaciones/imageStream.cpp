@@ -0,0 +1,128 @@
+#include "imageStream.h"
+#include "asciiCodec.h"
+#include "tiledFormat.h"
+#include <iostream>
+
+imageStream::imageStream() : Image(), input(nullptr), blockPosition(0), blockStart(0), blockEnd(0) {
+}
+
+imageStream::~imageStream() {
+}
+
+// Como Image::loadFromFile, pero el archivo queda abierto para readRows
+bool imageStream::loadFromFile(const char* filename) {
+    if (!source.open(filename)) {
+        return false;
+    }
+    if (!readMagicNumber(source.stream(), magicNumber)) {
+        std::cerr << "Error: Formato no soportado. Número mágico: " << magicNumber << std::endl;
+        return false;
+    }
+    compressedSource = source.isCompressed();
+    return loadFromStream(source.stream(), filename);
+}
+
+bool imageStream::loadFromStream(std::istream& file, const char* filename) {
+    (void)filename;
+    input = &file;
+    parseHeader(*input);
+    if (!isValidFormat()) {
+        std::cerr << "Error: Formato de archivo inválido" << std::endl;
+        return false;
+    }
+    sampleBytes = sampleBytesFor(maxValue);
+
+    if (!isBinary()) {
+        // Los números se convierten desde bloques de 1 MiB, como en la carga completa
+        block.resize(static_cast<size_t>(1) << 20);
+        blockPosition = static_cast<size_t>(input->tellg());
+        blockStart = blockEnd = 0;
+    }
+    return true;
+}
+
+bool imageStream::saveToFile(const char* filename) {
+    // El índice de mosaicos va antes que los píxeles: no se escribe por filas
+    if (tiledFormat::isTiledName(filename)) {
+        std::cerr << "Error: " << filename << " no se puede escribir en flujo (caché en mosaicos)" << std::endl;
+        return false;
+    }
+    if (!output.open(filename)) {
+        return false;
+    }
+    output.stream() << headerText();
+    return static_cast<bool>(output.stream());
+}
+
+void imageStream::displayInfo() const {
+    std::cout << "=== Información de Imagen (lectura en flujo) ===" << std::endl;
+    std::cout << "Número mágico: " << magicNumber << std::endl;
+    std::cout << "Dimensiones: " << width << " x " << height << " píxeles" << std::endl;
+    std::cout << "Valor máximo: " << maxValue << std::endl;
+    std::cout << "Almacenamiento: " << (sampleBytes * 8) << " bits por muestra" << std::endl;
+    std::cout << "Comentarios: " << commentCount << std::endl;
+    if (commentCount > 0) {
+        printComments();
+    }
+    std::cout << "================================================" << std::endl;
+}
+
+// Un número puede quedar partido entre dos bloques: el analizador conserva
+// el estado y lo que sobra del bloque queda para las filas siguientes
+template<typename T>
+bool imageStream::readAsciiRows(const imageView* channels) {
+    size_t samples = static_cast<size_t>(channels[0].width) * channels[0].height * getChannelCount();
+    asciiParser<T> parser(channels, getChannelCount(), maxValue, 0, samples);
+
+    while (!parser.isComplete()) {
+        if (blockStart == blockEnd) {
+            blockPosition += blockEnd;
+            input->read(block.data(), block.size());
+            blockStart = 0;
+            blockEnd = static_cast<size_t>(input->gcount());
+            if (blockEnd == 0) break;
+        }
+        const char* begin = block.data() + blockStart;
+        const char* stop = parser.feed(begin, block.data() + blockEnd, blockPosition + blockStart);
+        if (parser.failed()) {
+            parser.error.report();
+            return false;
+        }
+        blockStart = static_cast<size_t>(stop - block.data());
+    }
+    parser.finish();
+    if (!parser.isComplete()) {
+        std::cerr << "Error: No se pudieron leer todos los píxeles" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool imageStream::readRows(const imageView* channels) {
+    if (isBinary()) {
+        return readBinaryPixels(*input, channels, getChannelCount(), maxValue);
+    }
+    return sampleBytes == 1 ? readAsciiRows<uint8_t>(channels) : readAsciiRows<uint16_t>(channels);
+}
+
+template<typename T>
+bool imageStream::writeAsciiRows(const imageView* channels) {
+    size_t rowMax = static_cast<size_t>(channels[0].width) * getChannelCount() * MAX_SAMPLE_CHARS;
+    text.resize(rowMax * channels[0].height);
+    char* out = text.data();
+    for (int y = 0; y < channels[0].height; y++) {
+        out = formatAsciiRow<T>(out, channels, getChannelCount(), y);
+    }
+    return static_cast<bool>(output.stream().write(text.data(), out - text.data()));
+}
+
+bool imageStream::writeRows(const imageView* channels) {
+    if (isBinary()) {
+        return writeBinaryPixels(output.stream(), channels, getChannelCount());
+    }
+    return sampleBytes == 1 ? writeAsciiRows<uint8_t>(channels) : writeAsciiRows<uint16_t>(channels);
+}
+
+bool imageStream::finish() {
+    return output.close();
+}
@@ -0,0 +1,53 @@
+#ifndef IMAGE_STREAM_H
+#define IMAGE_STREAM_H
+
+#include "image.h"
+#include "imageView.h"
+#include "compressedInput.h"
+#include "compressedOutput.h"
+#include <vector>
+
+// Imagen PGM o PPM que nunca está entera en memoria. La carga solo lee
+// la cabecera y deja el archivo abierto para recorrer las filas en orden con
+// readRows; saveToFile escribe la cabecera y writeRows añade las filas.
+// Las filas se describen con una vista por canal (channelCount vistas)
+class imageStream : public Image {
+private:
+    imageInput source;        // Archivo abierto por loadFromFile (quizá gzip)
+    std::istream* input;      // Flujo del que se leen las filas
+    imageOutput output;       // Archivo de salida (gzip si termina en .gz)
+    std::vector<char> block;  // Texto ASCII leído y todavía no convertido
+    size_t blockPosition;     // Byte del archivo donde empieza block
+    size_t blockStart;        // Primer carácter de block sin consumir
+    size_t blockEnd;          // Caracteres válidos en block
+    std::vector<char> text;   // Filas de salida ASCII ya formateadas
+
+    template<typename T> bool readAsciiRows(const imageView* channels);
+    template<typename T> bool writeAsciiRows(const imageView* channels);
+
+public:
+    imageStream();
+    ~imageStream();
+
+    // Solo la cabecera; las filas se leen después con readRows
+    bool loadFromFile(const char* filename) override;
+    // file debe seguir abierto mientras se leen filas
+    bool loadFromStream(std::istream& file, const char* filename) override;
+    // Solo la cabecera; las filas se añaden después con writeRows
+    bool saveToFile(const char* filename) override;
+    void displayInfo() const override;
+    void fillHalo() override {}
+
+    int getChannelCount() const { return isColor() ? 3 : 1; }
+    // Misma cabecera que otra imagen (tipo, dimensiones, maxValue, comentarios)
+    void copyHeader(const Image& other) { copyHeaderFrom(other); }
+
+    // Siguientes channels[0].height filas del archivo de entrada
+    bool readRows(const imageView* channels);
+    // Añade channels[0].height filas al archivo de salida
+    bool writeRows(const imageView* channels);
+    // Cierra la salida; false si alguna escritura falló
+    bool finish();
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef IMAGE_VIEW_H
+#define IMAGE_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Vista no propietaria sobre un canal de una imagen o sobre una región de él.
+// No reserva ni copia memoria: solo describe cómo recorrer muestras que
+// pertenecen a otro objeto, por lo que se puede copiar y pasar por valor.
+//
+// El halo indica cuántas columnas/filas fuera de la región se pueden leer.
+// Más allá del halo está el borde real de la imagen, así que recortar las
+// coordenadas a [-halo, tamaño + halo) reproduce el manejo de bordes por
+// repetición aunque la vista sea solo un cuadrante o una franja.
+struct imageView {
+    unsigned char* data;  // Primera muestra de la región (x = 0, y = 0)
+    int width;
+    int height;
+    int stride;           // Muestras entre el inicio de dos filas consecutivas
+    int step;             // Muestras entre dos píxeles consecutivos (1 plano, 3 intercalado)
+    int sampleBytes;      // 1 (uint8_t) o 2 (uint16_t)
+    int haloLeft;
+    int haloTop;
+    int haloRight;
+    int haloBottom;
+
+    imageView()
+        : data(nullptr), width(0), height(0), stride(0), step(1), sampleBytes(1),
+          haloLeft(0), haloTop(0), haloRight(0), haloBottom(0) {}
+
+    imageView(unsigned char* base, int w, int h, int rowStride, int pixelStep, int bytes)
+        : data(base), width(w), height(h), stride(rowStride), step(pixelStep), sampleBytes(bytes),
+          haloLeft(0), haloTop(0), haloRight(0), haloBottom(0) {}
+
+    bool isValid() const { return data != nullptr && width > 0 && height > 0; }
+
+    // Fila y (puede estar dentro del halo). T debe coincidir con sampleBytes
+    template<typename T> T* row(int y) const {
+        return reinterpret_cast<T*>(data) + static_cast<ptrdiff_t>(y) * stride;
+    }
+
+    // Lectura/escritura sin verificación de límites
+    int sample(int x, int y) const {
+        ptrdiff_t index = static_cast<ptrdiff_t>(y) * stride + static_cast<ptrdiff_t>(x) * step;
+        return sampleBytes == 1 ? data[index] : reinterpret_cast<const uint16_t*>(data)[index];
+    }
+    void putSample(int x, int y, int value) const {
+        ptrdiff_t index = static_cast<ptrdiff_t>(y) * stride + static_cast<ptrdiff_t>(x) * step;
+        if (sampleBytes == 1) data[index] = static_cast<uint8_t>(value);
+        else reinterpret_cast<uint16_t*>(data)[index] = static_cast<uint16_t>(value);
+    }
+
+    // Coordenadas recortadas a la zona legible (región + halo)
+    int clampX(int x) const {
+        return x < -haloLeft ? -haloLeft : (x >= width + haloRight ? width + haloRight - 1 : x);
+    }
+    int clampY(int y) const {
+        return y < -haloTop ? -haloTop : (y >= height + haloBottom ? height + haloBottom - 1 : y);
+    }
+
+    // Interior para un kernel de radio radius: columnas [begin, end) y filas
+    // [begin, end) cuyos vecinos caen todos en la zona legible, de modo que
+    // ahí no hace falta recortar coordenadas. Fuera queda un marco de a lo
+    // sumo radius píxeles (nada si el halo ya cubre el radio)
+    void interiorColumns(int radius, int& begin, int& end) const {
+        interiorRange(width, haloLeft, haloRight, radius, begin, end);
+    }
+    void interiorRows(int radius, int& begin, int& end) const {
+        interiorRange(height, haloTop, haloBottom, radius, begin, end);
+    }
+
+    // Subregión [x, x + w) x [y, y + h). Lo que queda fuera de ella dentro de
+    // esta vista (más el halo propio) pasa a ser el halo de la subregión
+    imageView region(int x, int y, int w, int h) const {
+        imageView sub = *this;
+        sub.data = data + (static_cast<ptrdiff_t>(y) * stride + static_cast<ptrdiff_t>(x) * step) * sampleBytes;
+        sub.width = w;
+        sub.height = h;
+        sub.haloLeft = haloLeft + x;
+        sub.haloTop = haloTop + y;
+        sub.haloRight = haloRight + (width - x - w);
+        sub.haloBottom = haloBottom + (height - y - h);
+        return sub;
+    }
+
+private:
+    static void interiorRange(int size, int haloBefore, int haloAfter, int radius, int& begin, int& end) {
+        begin = radius > haloBefore ? radius - haloBefore : 0;
+        if (begin > size) begin = size;
+        end = size + haloAfter - radius;
+        if (end > size) end = size;
+        if (end < begin) end = begin;
+    }
+};
+
+#endif
@@ -1,9 +1,11 @@
 #include "imagesPGM.h"
+#include "compressedOutput.h"
+#include "tiledFormat.h"
 #include <iostream>
 #include <fstream>
 #include <cstring>
 
-imagesPGM::imagesPGM() : Image(), pixels(nullptr) {
+imagesPGM::imagesPGM() : Image(), buffer(nullptr), bufferBytes(0), pixels(nullptr), stride(0) {
 }
 
 imagesPGM::~imagesPGM() {
@@ -12,71 +14,111 @@ imagesPGM::~imagesPGM() {
 
 void imagesPGM::allocateMemory() {
     if (width > 0 && height > 0) {
-        pixels = new int*[height];
-        for (int i = 0; i < height; i++) {
-            pixels[i] = new int[width];
-        }
+        // Una sola reserva alineada para toda la imagen: las filas quedan
+        // contiguas, rodeadas por halo filas/columnas de relleno.
+        // El tamaño de muestra se elige según maxValue (8 o 16 bits)
+        sampleBytes = sampleBytesFor(maxValue);
+        int leftPad;
+        paddedRowLayout(1, leftPad, stride);
+        bufferBytes = static_cast<size_t>(height + 2 * halo) * stride * sampleBytes;
+        buffer = acquireBuffer(bufferBytes);
+        pixels = buffer + (static_cast<size_t>(halo) * stride + leftPad) * sampleBytes;
     }
 }
 
 void imagesPGM::deallocateMemory() {
-    if (pixels) {
-        for (int i = 0; i < height; i++) {
-            delete[] pixels[i];
-        }
-        delete[] pixels;
-        pixels = nullptr;
+    if (buffer) {
+        releaseBuffer(buffer);
+        buffer = nullptr;
+        bufferBytes = 0;
     }
+    unmapPixels();
+    pixels = nullptr;
+    stride = 0;
 }
 
-bool imagesPGM::loadFromFile(const char* filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Error: No se puede abrir el archivo " << filename << std::endl;
-        return false;
+void imagesPGM::fillHalo() {
+    if (pixels) {
+        replicateHalo(getView(), halo);
     }
-    
+}
+
+bool imagesPGM::loadFromStream(std::istream& file, const char* filename) {
     try {
         parseHeader(file);
         
-        if (strcmp(magicNumber, "P2") != 0) {
-            std::cerr << "Error: Formato no válido. Se esperaba P2, se encontró " 
+        if (!isGrayscale()) {
+            std::cerr << "Error: Formato no válido. Se esperaba P2 o P5, se encontró " 
                       << magicNumber << std::endl;
-            file.close();
             return false;
         }
         
         if (!isValidFormat()) {
             std::cerr << "Error: Formato de archivo inválido" << std::endl;
-            file.close();
             return false;
         }
 
         deallocateMemory();
-        allocateMemory();
-        for (int i = 0; i < height; i++) {
-            for (int j = 0; j < width; j++) {
-                if (!(file >> pixels[i][j])) {
-                    std::cerr << "Error: No se pudieron leer todos los píxeles" << std::endl;
-                    file.close();
-                    return false;
-                }
-                if (pixels[i][j] < 0 || pixels[i][j] > maxValue) {
-                    std::cerr << "Error: Valor de píxel fuera de rango: " 
-                              << pixels[i][j] << std::endl;
-                    file.close();
-                    return false;
-                }
+        if (canMapPixels()) {
+            // Sin copia: los píxeles son los bytes del archivo proyectado
+            std::streamoff offset = file.tellg();
+            pixels = mapPixels(filename, offset, 1);
+            if (!pixels) {
+                return false;
             }
+            stride = width;
+            std::cout << "Archivo PGM " << filename << " proyectado en memoria" << std::endl;
+            return true;
+        }
+        allocateMemory();
+        imageView view = getView();
+        bool ok = tiledSource ? tiledFormat::readRegion(file, width, height, &view, 1, maxValue, 0, 0)
+                : isBinary() ? readBinaryPixels(file, &view, 1, maxValue)
+                             : readAsciiPixels(file, &view, 1, maxValue);
+        if (!ok) {
+            return false;
+        }
+        if (!tiledSource) {
+            fillHalo();
         }
         
-        file.close();
-        std::cout << "Archivo PGM " << filename << " cargado exitosamente" << std::endl;
+        std::cout << "Archivo PGM " << filename << " cargado exitosamente"
+                  << (tiledSource ? " (caché en mosaicos)" : "")
+                  << (compressedSource ? " (descomprimido de gzip)" : "") << std::endl;
         return true;
         
     } catch (const std::exception& e) {
         std::cerr << "Error al cargar archivo PGM: " << e.what() << std::endl;
-        file.close();
+        return false;
+    }
+}
+
+// El halo se lee de los píxeles vecinos de la caché, no se replica
+bool imagesPGM::loadRegionFromStream(std::istream& file, const char* filename, int x, int y, int w, int h) {
+    try {
+        int fullWidth, fullHeight;
+        if (!parseRegionHeader(file, x, y, w, h, fullWidth, fullHeight)) {
+            return false;
+        }
+        if (!isGrayscale()) {
+            std::cerr << "Error: Formato no válido. Se esperaba P2 o P5, se encontró "
+                      << magicNumber << std::endl;
+            return false;
+        }
+
+        deallocateMemory();
+        allocateMemory();
+        imageView view = getView();
+        if (!tiledFormat::readRegion(file, fullWidth, fullHeight, &view, 1, maxValue, x, y)) {
+            return false;
+        }
+
+        std::cout << "Región " << w << "x" << h << " en (" << x << ", " << y << ") de "
+                  << filename << " cargada exitosamente" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error al cargar región PGM: " << e.what() << std::endl;
         return false;
     }
 }
@@ -86,37 +128,46 @@ bool imagesPGM::saveToFile(const char* filename) {
         std::cerr << "Error: No hay datos de imagen para guardar" << std::endl;
         return false;
     }
+
+    if (isMappedOutput(filename)) {
+        // Los filtros ya escribieron los píxeles en el archivo proyectado;
+        // solo falta ponerlo en lugar del destino
+        if (!commitMappedOutput()) {
+            return false;
+        }
+        std::cout << "Archivo PGM " << filename << " guardado exitosamente (proyección en memoria)" << std::endl;
+        return true;
+    }
     
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: No se puede crear el archivo " << filename << std::endl;
+    // Con nombre terminado en .gz el texto se comprime en paralelo al escribirlo
+    imageOutput output;
+    if (!output.open(filename)) {
         return false;
     }
+    std::ostream& file = output.stream();
     
     try {
-        file << "P2" << std::endl;
-        for (int i = 0; i < commentCount; i++) {
-            file << comments[i] << std::endl;
+        bool tiled = tiledFormat::isTiledName(filename);
+        if (tiled) {
+            file << tiledFormat::magicNumber() << '\n';
         }
-        
-        file << width << " " << height << std::endl;
-        file << maxValue << std::endl;
+        file << headerText();
 
-        for (int i = 0; i < height; i++) {
-            for (int j = 0; j < width; j++) {
-                file << pixels[i][j];
-                if (j < width - 1) file << " ";
-            }
-            file << std::endl;
+        imageView view = getView();
+        bool ok = tiled ? tiledFormat::write(file, &view, 1, tiledFormat::DEFAULT_TILE_SIZE)
+                : isBinary() ? writeBinaryPixels(file, &view, 1)
+                             : writeAsciiPixels(file, &view, 1, output.isCompressed() ? nullptr : filename);
+        if (!output.close() || !ok) {
+            std::cerr << "Error: No se pudieron escribir los píxeles en " << filename << std::endl;
+            return false;
         }
         
-        file.close();
-        std::cout << "Archivo PGM " << filename << " guardado exitosamente" << std::endl;
+        std::cout << "Archivo PGM " << filename << " guardado exitosamente"
+                  << (output.isCompressed() ? " (comprimido con gzip)" : "") << std::endl;
         return true;
         
     } catch (const std::exception& e) {
         std::cerr << "Error al guardar archivo PGM: " << e.what() << std::endl;
-        file.close();
         return false;
     }
 }
@@ -126,6 +177,11 @@ void imagesPGM::displayInfo() const {
     std::cout << "Número mágico: " << magicNumber << std::endl;
     std::cout << "Dimensiones: " << width << " x " << height << " píxeles" << std::endl;
     std::cout << "Valor máximo: " << maxValue << std::endl;
+    std::cout << "Almacenamiento: " << (sampleBytes * 8) << " bits por muestra" << std::endl;
+    if (halo > 0) {
+        std::cout << "Relleno: " << halo << " píxel(es) por borde, filas alineadas a " 
+                  << BUFFER_ALIGNMENT << " bytes" << std::endl;
+    }
     std::cout << "Comentarios: " << commentCount << std::endl;
     
     if (commentCount > 0) {
@@ -141,7 +197,7 @@ void imagesPGM::displayInfo() const {
 
 int imagesPGM::getPixel(int x, int y) const {
     if (x >= 0 && x < width && y >= 0 && y < height && pixels) {
-        return pixels[y][x];
+        return getSample(x, y);
     }
     return 0;
 }
@@ -150,33 +206,45 @@ void imagesPGM::setPixel(int x, int y, int value) {
     if (x >= 0 && x < width && y >= 0 && y < height && pixels) {
         if (value < 0) value = 0;
         if (value > maxValue) value = maxValue;
-        pixels[y][x] = value;
+        putSample(x, y, value);
     }
 }
 
 imagesPGM* imagesPGM::clone() const {
-    imagesPGM* copy = new imagesPGM();
-    strcpy(copy->magicNumber, this->magicNumber);
-    copy->width = this->width;
-    copy->height = this->height;
-    copy->maxValue = this->maxValue;
-    copy->commentCount = this->commentCount;
-    if (this->commentCount > 0) {
-        copy->comments = new char*[this->commentCount];
-        for (int i = 0; i < this->commentCount; i++) {
-            int len = strlen(this->comments[i]);
-            copy->comments[i] = new char[len + 1];
-            strcpy(copy->comments[i], this->comments[i]);
-        }
+    imagesPGM* copy = createLike();
+    if (this->buffer && copy->buffer) {
+        // Misma geometría: se copia también el relleno ya replicado
+        memcpy(copy->buffer, this->buffer, bufferBytes);
+    } else if (this->pixels && copy->pixels) {
+        // Proyección en memoria: filas compactas sin relleno en ambas
+        memcpy(copy->pixels, this->pixels, static_cast<size_t>(height) * stride * sampleBytes);
     }
+    
+    return copy;
+}
+
+imagesPGM* imagesPGM::createLike(bool parallelFirstTouch) const {
+    imagesPGM* copy = new imagesPGM();
+    copy->copyHeaderFrom(*this);
     copy->allocateMemory();
-    if (this->pixels && copy->pixels) {
-        for (int i = 0; i < height; i++) {
-            for (int j = 0; j < width; j++) {
-                copy->pixels[i][j] = this->pixels[i][j];
-            }
-        }
+    if (parallelFirstTouch && copy->buffer) {
+        firstTouch(copy->buffer, copy->bufferBytes);
     }
-    
     return copy;
-}
\ No newline at end of file
+}
+
+imagesPGM* imagesPGM::createMappedOutput(const char* filename) const {
+    if (!isBinary() || sampleBytesFor(maxValue) != 1 || imageOutput::isCompressedName(filename) ||
+        tiledFormat::isTiledName(filename)) {
+        return nullptr;
+    }
+    imagesPGM* copy = new imagesPGM();
+    copy->copyHeaderFrom(*this);
+    copy->pixels = copy->mapOutputPixels(filename, 1);
+    if (!copy->pixels) {
+        delete copy;
+        return nullptr;
+    }
+    copy->stride = width;
+    return copy;
+}
@@ -2,10 +2,14 @@
 #define IMAGES_PGM_H
 
 #include "image.h"
+#include "imageView.h"
 
 class imagesPGM : public Image {
 private:
-    int** pixels; 
+    unsigned char* buffer;  // Inicio alineado del buffer (del pool), incluido el relleno superior
+    size_t bufferBytes;     // Bytes de buffer: (height + 2 * halo) * stride * sampleBytes
+    unsigned char* pixels;  // Muestra (0, 0) dentro de buffer
+    int stride;             // Muestras entre el inicio de dos filas consecutivas
     
     void allocateMemory();
     void deallocateMemory();
@@ -13,14 +17,51 @@ private:
 public:
     imagesPGM();
     ~imagesPGM();
-    bool loadFromFile(const char* filename) override;
+    bool loadFromStream(std::istream& file, const char* filename) override;
+    bool loadRegionFromStream(std::istream& file, const char* filename, int x, int y, int w, int h) override;
     bool saveToFile(const char* filename) override;
     void displayInfo() const override;
+    void fillHalo() override;
     int getPixel(int x, int y) const;
     void setPixel(int x, int y, int value);
     void convertFromPPM(const class PPMImage& ppmImage);
-    int** getPixels() const { return pixels; }
+    unsigned char* getPixels() const { return pixels; }
+    int getStride() const { return stride; }
+
+    // Acceso directo a filas sin verificación de límites (y en [0, height)).
+    // T debe coincidir con getSampleBytes(): uint8_t (1) o uint16_t (2)
+    template<typename T> T* getRow(int y) {
+        return reinterpret_cast<T*>(pixels) + static_cast<size_t>(y) * stride;
+    }
+    template<typename T> const T* getRow(int y) const {
+        return reinterpret_cast<const T*>(pixels) + static_cast<size_t>(y) * stride;
+    }
+
+    // Lectura/escritura de una muestra sin verificación de límites ni recorte
+    int getSample(int x, int y) const {
+        return sampleBytes == 1 ? getRow<uint8_t>(y)[x] : getRow<uint16_t>(y)[x];
+    }
+    void putSample(int x, int y, int value) {
+        if (sampleBytes == 1) getRow<uint8_t>(y)[x] = static_cast<uint8_t>(value);
+        else getRow<uint16_t>(y)[x] = static_cast<uint16_t>(value);
+    }
+
+    // Vista no propietaria de la imagen completa; el relleno replicado
+    // cuenta como halo legible
+    imageView getView() const {
+        imageView view(pixels, width, height, stride, 1, sampleBytes);
+        view.haloLeft = view.haloTop = view.haloRight = view.haloBottom = halo;
+        return view;
+    }
     imagesPGM* clone() const;
+    // Imagen con la misma cabecera y organización, sin copiar los píxeles
+    // (quedan sin inicializar); firstTouch reparte el primer acceso entre hilos
+    imagesPGM* createLike(bool parallelFirstTouch = false) const;
+    // Como createLike, pero con los píxeles dentro de filename (P5/P6 de 8 bits
+    // sin comprimir),
+    // creado ya con su tamaño final: lo que escriben los filtros queda guardado
+    // y saveToFile(filename) no repite la escritura. nullptr si no es posible
+    imagesPGM* createMappedOutput(const char* filename) const;
 };
 
 #endif
\ No newline at end of file
@@ -1,11 +1,14 @@
 #include "imagesPPM.h"
 #include "imagesPGM.h"
+#include "compressedOutput.h"
+#include "tiledFormat.h"
 #include <iostream>
 #include <fstream>
 #include <cstring>
 
-imagesPPM::imagesPPM() : Image(), pixels(nullptr) {
-    
+imagesPPM::imagesPPM(ppmLayout initialLayout)
+    : Image(), layout(initialLayout), buffer(nullptr), bufferBytes(0), pixels(nullptr), stride(0) {
+    planes[0] = planes[1] = planes[2] = nullptr;
 }
 
 imagesPPM::~imagesPPM() {
@@ -14,72 +17,131 @@ imagesPPM::~imagesPPM() {
 
 void imagesPPM::allocateMemory() {
     if (width > 0 && height > 0) {
-        pixels = new RGB*[height];
-        for (int i = 0; i < height; i++) {
-            pixels[i] = new RGB[width];
+        // Una sola reserva alineada para las tres componentes; 8 o 16 bits
+        // según maxValue. Cada fila (o cada plano) lleva halo píxeles de relleno
+        sampleBytes = sampleBytesFor(maxValue);
+        int leftPad;
+        paddedRowLayout(layout == PPM_PLANAR ? 1 : 3, leftPad, stride);
+        size_t originOffset = (static_cast<size_t>(halo) * stride + leftPad) * sampleBytes;
+        size_t planeBytes = static_cast<size_t>(height + 2 * halo) * stride * sampleBytes;
+        bufferBytes = (layout == PPM_PLANAR) ? 3 * planeBytes : planeBytes;
+        buffer = acquireBuffer(bufferBytes);
+        if (layout == PPM_PLANAR) {
+            // Los tres planos quedan uno detrás del otro
+            planes[0] = buffer + originOffset;
+            planes[1] = buffer + planeBytes + originOffset;
+            planes[2] = buffer + 2 * planeBytes + originOffset;
         }
+        pixels = buffer + originOffset;
     }
 }
 
 void imagesPPM::deallocateMemory() {
+    if (buffer) {
+        releaseBuffer(buffer);
+        buffer = nullptr;
+        bufferBytes = 0;
+    }
+    unmapPixels();
+    pixels = nullptr;
+    planes[0] = planes[1] = planes[2] = nullptr;
+    stride = 0;
+}
+
+void imagesPPM::fillHalo() {
     if (pixels) {
-        for (int i = 0; i < height; i++) {
-            delete[] pixels[i];
+        for (int c = 0; c < 3; c++) {
+            replicateHalo(getChannelView(c), halo);
         }
-        delete[] pixels;
-        pixels = nullptr;
     }
 }
 
-bool imagesPPM::loadFromFile(const char* filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Error: No se puede abrir el archivo " << filename << std::endl;
-        return false;
+void imagesPPM::setLayout(ppmLayout newLayout) {
+    if (pixels) {
+        std::cerr << "Advertencia: La organización de una imagen PPM cargada no se puede cambiar" << std::endl;
+        return;
     }
-    
+    layout = newLayout;
+}
+
+bool imagesPPM::loadFromStream(std::istream& file, const char* filename) {
     try {
         parseHeader(file);
-        if (strcmp(magicNumber, "P3") != 0) {
-            std::cerr << "Error: Formato no válido. Se esperaba P3, se encontró " 
+        if (!isColor()) {
+            std::cerr << "Error: Formato no válido. Se esperaba P3 o P6, se encontró " 
                       << magicNumber << std::endl;
-            file.close();
             return false;
         }
         
         if (!isValidFormat()) {
             std::cerr << "Error: Formato de archivo inválido" << std::endl;
-            file.close();
             return false;
         }
         deallocateMemory();
-        allocateMemory();
-        for (int i = 0; i < height; i++) {
-            for (int j = 0; j < width; j++) {
-                int r, g, b;
-                if (!(file >> r >> g >> b)) {
-                    std::cerr << "Error: No se pudieron leer todos los píxeles RGB" << std::endl;
-                    file.close();
-                    return false;
-                }
-                if (r < 0 || r > maxValue || g < 0 || g > maxValue || b < 0 || b > maxValue) {
-                    std::cerr << "Error: Valor de píxel fuera de rango: RGB(" 
-                              << r << "," << g << "," << b << ")" << std::endl;
-                    file.close();
-                    return false;
-                }
-                
-                pixels[i][j] = RGB(r, g, b);
+        if (canMapPixels()) {
+            // Sin copia: el archivo ya guarda los píxeles intercalados. La
+            // proyección tiene prioridad sobre una organización planar pedida,
+            // porque los filtros recorren las vistas de canal de cualquiera de las dos
+            layout = PPM_INTERLEAVED;
+            std::streamoff offset = file.tellg();
+            pixels = mapPixels(filename, offset, 3);
+            if (!pixels) {
+                return false;
             }
+            stride = 3 * width;
+            std::cout << "Archivo PPM " << filename << " proyectado en memoria" << std::endl;
+            return true;
+        }
+        allocateMemory();
+        
+        imageView views[3] = { getChannelView(0), getChannelView(1), getChannelView(2) };
+        bool ok = tiledSource ? tiledFormat::readRegion(file, width, height, views, 3, maxValue, 0, 0)
+                : isBinary() ? readBinaryPixels(file, views, 3, maxValue)
+                             : readAsciiPixels(file, views, 3, maxValue);
+        if (!ok) {
+            return false;
+        }
+        if (!tiledSource) {
+            fillHalo();
         }
         
-        file.close();
-        std::cout << "Archivo PPM " << filename << " cargado exitosamente" << std::endl;
+        std::cout << "Archivo PPM " << filename << " cargado exitosamente"
+                  << (tiledSource ? " (caché en mosaicos)" : "")
+                  << (compressedSource ? " (descomprimido de gzip)" : "") << std::endl;
         return true;
         
     } catch (const std::exception& e) {
         std::cerr << "Error al cargar archivo PPM: " << e.what() << std::endl;
-        file.close();
+        return false;
+    }
+}
+
+// El halo se lee de los píxeles vecinos de la caché, no se replica
+bool imagesPPM::loadRegionFromStream(std::istream& file, const char* filename, int x, int y, int w, int h) {
+    try {
+        int fullWidth, fullHeight;
+        if (!parseRegionHeader(file, x, y, w, h, fullWidth, fullHeight)) {
+            return false;
+        }
+        if (!isColor()) {
+            std::cerr << "Error: Formato no válido. Se esperaba P3 o P6, se encontró "
+                      << magicNumber << std::endl;
+            return false;
+        }
+
+        deallocateMemory();
+        allocateMemory();
+        imageView views[3] = { getChannelView(0), getChannelView(1), getChannelView(2) };
+        if (!tiledFormat::readRegion(file, fullWidth, fullHeight, views, 3, maxValue, x, y)) {
+            return false;
+        }
+
+        std::cout << "Región " << w << "x" << h << " en (" << x << ", " << y << ") de "
+                  << filename << " cargada exitosamente" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error al cargar región PPM: " << e.what() << std::endl;
         return false;
     }
 }
@@ -89,38 +151,45 @@ bool imagesPPM::saveToFile(const char* filename) {
         std::cerr << "Error: No hay datos de imagen para guardar" << std::endl;
         return false;
     }
+
+    if (isMappedOutput(filename)) {
+        // Los filtros ya escribieron los píxeles en el archivo proyectado;
+        // solo falta ponerlo en lugar del destino
+        if (!commitMappedOutput()) {
+            return false;
+        }
+        std::cout << "Archivo PPM " << filename << " guardado exitosamente (proyección en memoria)" << std::endl;
+        return true;
+    }
     
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: No se puede crear el archivo " << filename << std::endl;
+    // Con nombre terminado en .gz el texto se comprime en paralelo al escribirlo
+    imageOutput output;
+    if (!output.open(filename)) {
         return false;
     }
+    std::ostream& file = output.stream();
     
     try {
-        file << "P3" << std::endl;
-        for (int i = 0; i < commentCount; i++) {
-            file << comments[i] << std::endl;
+        bool tiled = tiledFormat::isTiledName(filename);
+        if (tiled) {
+            file << tiledFormat::magicNumber() << '\n';
         }
-        
-        file << width << " " << height << std::endl;
-        file << maxValue << std::endl;
-        for (int i = 0; i < height; i++) {
-            for (int j = 0; j < width; j++) {
-                file << pixels[i][j].r << " " 
-                     << pixels[i][j].g << " " 
-                     << pixels[i][j].b;
-                if (j < width - 1) file << " ";
-            }
-            file << std::endl;
+        file << headerText();
+        imageView views[3] = { getChannelView(0), getChannelView(1), getChannelView(2) };
+        bool ok = tiled ? tiledFormat::write(file, views, 3, tiledFormat::DEFAULT_TILE_SIZE)
+                : isBinary() ? writeBinaryPixels(file, views, 3)
+                             : writeAsciiPixels(file, views, 3, output.isCompressed() ? nullptr : filename);
+        if (!output.close() || !ok) {
+            std::cerr << "Error: No se pudieron escribir los píxeles en " << filename << std::endl;
+            return false;
         }
         
-        file.close();
-        std::cout << "Archivo PPM " << filename << " guardado exitosamente" << std::endl;
+        std::cout << "Archivo PPM " << filename << " guardado exitosamente"
+                  << (output.isCompressed() ? " (comprimido con gzip)" : "") << std::endl;
         return true;
         
     } catch (const std::exception& e) {
         std::cerr << "Error al guardar archivo PPM: " << e.what() << std::endl;
-        file.close();
         return false;
     }
 }
@@ -136,6 +205,13 @@ void imagesPPM::displayInfo() const {
         printComments();
     }
     
+    std::cout << "Almacenamiento: " << (sampleBytes * 8) << " bits por muestra" << std::endl;
+    if (halo > 0) {
+        std::cout << "Relleno: " << halo << " píxel(es) por borde, filas alineadas a " 
+                  << BUFFER_ALIGNMENT << " bytes" << std::endl;
+    }
+    std::cout << "Organización: " << (layout == PPM_PLANAR ? "planar (RRR GGG BBB)" : "intercalada (RGB RGB)") << std::endl;
+    
     if (pixels) {
         std::cout << "Estado: Imagen cargada correctamente" << std::endl;
     } else {
@@ -144,8 +220,10 @@ void imagesPPM::displayInfo() const {
 }
 
 RGB imagesPPM::getPixel(int x, int y) const {
-    if (x >= 0 && x < width && y >= 0 && y < height && pixels) {
-        return pixels[y][x];
+    if (x >= 0 && x < width && y >= 0 && y < height) {
+        if (pixels) {
+            return RGB(getSample(0, x, y), getSample(1, x, y), getSample(2, x, y));
+        }
     }
     return RGB(0, 0, 0);
 }
@@ -160,7 +238,9 @@ void imagesPPM::setPixel(int x, int y, const RGB& color) {
         if (clampedColor.b < 0) clampedColor.b = 0;
         if (clampedColor.b > maxValue) clampedColor.b = maxValue;
         
-        pixels[y][x] = clampedColor;
+        putSample(0, x, y, clampedColor.r);
+        putSample(1, x, y, clampedColor.g);
+        putSample(2, x, y, clampedColor.b);
     }
 }
 
@@ -175,36 +255,50 @@ void imagesPPM::convertToGrayscale(imagesPGM& pgmImage) const {
 }
 
 int imagesPPM::getGrayscaleValue(int x, int y) const {
-    if (x >= 0 && x < width && y >= 0 && y < height && pixels) {
-        RGB pixel = pixels[y][x];
+    if (x >= 0 && x < width && y >= 0 && y < height) {
+        RGB pixel = getPixel(x, y);
         return static_cast<int>(0.299 * pixel.r + 0.587 * pixel.g + 0.114 * pixel.b);
     }
     return 0;
 }
 
 imagesPPM* imagesPPM::clone() const {
-    imagesPPM* copy = new imagesPPM();
-    strcpy(copy->magicNumber, this->magicNumber);
-    copy->width = this->width;
-    copy->height = this->height;
-    copy->maxValue = this->maxValue;
-    copy->commentCount = this->commentCount;
-    if (this->commentCount > 0) {
-        copy->comments = new char*[this->commentCount];
-        for (int i = 0; i < this->commentCount; i++) {
-            int len = strlen(this->comments[i]);
-            copy->comments[i] = new char[len + 1];
-            strcpy(copy->comments[i], this->comments[i]);
-        }
+    imagesPPM* copy = createLike();
+    if (this->buffer && copy->buffer) {
+        // Misma geometría: se copia también el relleno ya replicado
+        memcpy(copy->buffer, this->buffer, bufferBytes);
+    } else if (this->pixels && copy->pixels) {
+        // Proyección en memoria: filas compactas sin relleno en ambas
+        memcpy(copy->pixels, this->pixels, static_cast<size_t>(height) * stride * sampleBytes);
     }
+    
+    return copy;
+}
+
+imagesPPM* imagesPPM::createLike(bool parallelFirstTouch) const {
+    imagesPPM* copy = new imagesPPM(layout);
+    copy->copyHeaderFrom(*this);
     copy->allocateMemory();
-    if (this->pixels && copy->pixels) {
-        for (int i = 0; i < height; i++) {
-            for (int j = 0; j < width; j++) {
-                copy->pixels[i][j] = this->pixels[i][j];
-            }
-        }
+    if (parallelFirstTouch && copy->buffer) {
+        firstTouch(copy->buffer, copy->bufferBytes);
     }
-    
+    return copy;
+}
+
+imagesPPM* imagesPPM::createMappedOutput(const char* filename) const {
+    // El archivo guarda los píxeles intercalados: el modo planar no se puede proyectar
+    if (!isBinary() || sampleBytesFor(maxValue) != 1 || layout != PPM_INTERLEAVED ||
+        imageOutput::isCompressedName(filename) ||
+        tiledFormat::isTiledName(filename)) {
+        return nullptr;
+    }
+    imagesPPM* copy = new imagesPPM(layout);
+    copy->copyHeaderFrom(*this);
+    copy->pixels = copy->mapOutputPixels(filename, 3);
+    if (!copy->pixels) {
+        delete copy;
+        return nullptr;
+    }
+    copy->stride = 3 * width;
     return copy;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define IMAGES_PPM_H
 
 #include "image.h"
+#include "imageView.h"
 
 struct RGB {
     int r, g, b;
@@ -10,25 +11,100 @@ struct RGB {
     RGB(int red, int green, int blue) : r(red), g(green), b(blue) {}
 };
 
+// Organización en memoria de los canales de color
+enum ppmLayout {
+    PPM_INTERLEAVED, // RGB RGB RGB ... (un arreglo de estructuras)
+    PPM_PLANAR       // RRR... GGG... BBB... (un plano contiguo por canal)
+};
+
 class imagesPPM : public Image {    
 private:
-    RGB** pixels;
+    ppmLayout layout;
+    unsigned char* buffer;    // Inicio alineado del buffer único (del pool), incluido el relleno
+    size_t bufferBytes;       // Bytes de buffer (los tres canales con su relleno)
+    unsigned char* pixels;    // Muestra (0, 0) del primer canal (sampleBytes bytes c/u)
+    unsigned char* planes[3]; // Modo planar: muestra (0, 0) de cada plano dentro de buffer
+    int stride;               // Muestras entre el inicio de dos filas consecutivas
+                              // (>= 3 * width intercalado, >= width por plano en modo planar)
     
     void allocateMemory();
     void deallocateMemory();
+
+    // Posición de la muestra (canal, x, y) en unidades de muestra
+    size_t sampleIndex(int channel, int x, int y) const {
+        return layout == PPM_PLANAR
+            ? static_cast<size_t>(y) * stride + x
+            : static_cast<size_t>(y) * stride + 3 * x + channel;
+    }
     
 public:
-    imagesPPM();
+    imagesPPM(ppmLayout initialLayout = PPM_INTERLEAVED);
     ~imagesPPM();
-    bool loadFromFile(const char* filename) override;
+
+    // La organización se elige antes de cargar; no convierte datos ya cargados
+    void setLayout(ppmLayout newLayout);
+    ppmLayout getLayout() const { return layout; }
+    bool isPlanar() const { return layout == PPM_PLANAR; }
+    bool loadFromStream(std::istream& file, const char* filename) override;
+    bool loadRegionFromStream(std::istream& file, const char* filename, int x, int y, int w, int h) override;
     bool saveToFile(const char* filename) override;
     void displayInfo() const override;
+    void fillHalo() override;
     RGB getPixel(int x, int y) const;
     void setPixel(int x, int y, const RGB& color);
     void setPixel(int x, int y, int r, int g, int b);
     void convertToGrayscale(class imagesPGM& pgmImage) const;
-    RGB** getPixels() const { return pixels; }
+    unsigned char* getPixels() const { return pixels; }
+    int getStride() const { return stride; }
+
+    // Acceso directo sin verificación de límites (y en [0, height)).
+    // T debe coincidir con getSampleBytes(): uint8_t (1) o uint16_t (2)
+    template<typename T> T* getRow(int y) {
+        return reinterpret_cast<T*>(pixels) + static_cast<size_t>(y) * stride;
+    }
+    template<typename T> const T* getRow(int y) const {
+        return reinterpret_cast<const T*>(pixels) + static_cast<size_t>(y) * stride;
+    }
+    unsigned char* getPlane(int channel) { return planes[channel]; }
+    const unsigned char* getPlane(int channel) const { return planes[channel]; }
+    template<typename T> T* getPlaneRow(int channel, int y) {
+        return reinterpret_cast<T*>(planes[channel]) + static_cast<size_t>(y) * stride;
+    }
+    template<typename T> const T* getPlaneRow(int channel, int y) const {
+        return reinterpret_cast<const T*>(planes[channel]) + static_cast<size_t>(y) * stride;
+    }
+
+    // Lectura/escritura de una muestra sin verificación de límites ni recorte
+    int getSample(int channel, int x, int y) const {
+        const unsigned char* base = layout == PPM_PLANAR ? planes[channel] : pixels;
+        size_t index = sampleIndex(channel, x, y);
+        return sampleBytes == 1 ? base[index] : reinterpret_cast<const uint16_t*>(base)[index];
+    }
+    void putSample(int channel, int x, int y, int value) {
+        unsigned char* base = layout == PPM_PLANAR ? planes[channel] : pixels;
+        size_t index = sampleIndex(channel, x, y);
+        if (sampleBytes == 1) base[index] = static_cast<uint8_t>(value);
+        else reinterpret_cast<uint16_t*>(base)[index] = static_cast<uint16_t>(value);
+    }
+
+    // Vista no propietaria de un canal completo (plano o intercalado con paso 3);
+    // el relleno replicado cuenta como halo legible
+    imageView getChannelView(int channel) const {
+        imageView view = (layout == PPM_PLANAR)
+            ? imageView(planes[channel], width, height, stride, 1, sampleBytes)
+            : imageView(pixels + channel * sampleBytes, width, height, stride, 3, sampleBytes);
+        view.haloLeft = view.haloTop = view.haloRight = view.haloBottom = halo;
+        return view;
+    }
     imagesPPM* clone() const;
+    // Imagen con la misma cabecera y organización, sin copiar los píxeles
+    // (quedan sin inicializar); firstTouch reparte el primer acceso entre hilos
+    imagesPPM* createLike(bool parallelFirstTouch = false) const;
+    // Como createLike, pero con los píxeles dentro de filename (P5/P6 de 8 bits
+    // sin comprimir),
+    // creado ya con su tamaño final: lo que escriben los filtros queda guardado
+    // y saveToFile(filename) no repite la escritura. nullptr si no es posible
+    imagesPPM* createMappedOutput(const char* filename) const;
     int getGrayscaleValue(int x, int y) const;
 };
 
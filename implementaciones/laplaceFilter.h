@@ -4,22 +4,12 @@
 #include "filter.h"
 
 class laplaceFilter : public filter {
-private:
-    int* kernel;
-    
-    void initializeKernel();
-    
 public:
     laplaceFilter();
-    ~laplaceFilter();
 
     bool applyToPGM(imagesPGM* input, imagesPGM* output) override;
     bool applyToPPM(imagesPPM* input, imagesPPM* output) override;
-
-private:
-    // Métodos auxiliares para el filtro Laplaciano
-    int applyLaplaceKernel(imagesPGM* image, int x, int y);
-    RGB applyLaplaceKernelRGB(imagesPPM* image, int x, int y);
+    void applyToView(const imageView& src, const imageView& dst, int maxValue) override;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "mappedFile.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+mappedFile::mappedFile() : data(nullptr), size(0), shared(false) {
+}
+
+mappedFile::~mappedFile() {
+    close();
+}
+
+bool mappedFile::open(const char* filename) {
+    close();
+
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: No se puede abrir el archivo " << filename << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        std::cerr << "Error: No se puede obtener el tamaño de " << filename << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    // MAP_PRIVATE con escritura: las modificaciones quedan en el proceso
+    void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE, fd, 0);
+    // La proyección sigue siendo válida después de cerrar el descriptor
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        std::cerr << "Error: No se pudo proyectar " << filename << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    data = static_cast<unsigned char*>(address);
+    size = static_cast<size_t>(info.st_size);
+    shared = false;
+    this->filename = filename;
+    return true;
+}
+
+bool mappedFile::create(const char* filename, size_t bytes) {
+    close();
+
+    // Si el destino ya existe se escribe en el archivo real (un enlace
+    // simbólico sigue apuntando a él) y el temporal va en su mismo directorio
+    // para que rename no cruce sistemas de archivos
+    std::string target = filename;
+    char* resolved = realpath(filename, nullptr);
+    if (resolved) {
+        target = resolved;
+        free(resolved);
+    }
+    std::string temporary = target + ".XXXXXX";
+    int fd = mkstemp(&temporary[0]);
+    if (fd < 0) {
+        std::cerr << "Error: No se puede crear el archivo " << filename << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    fchmod(fd, 0644);
+
+    // Tamaño final desde el principio: cada hilo escribe en su posición definitiva
+    if (bytes == 0 || ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        std::cerr << "Error: No se pudo reservar el tamaño de " << filename << std::endl;
+        ::close(fd);
+        unlink(temporary.c_str());
+        return false;
+    }
+
+    void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        std::cerr << "Error: No se pudo proyectar " << filename << ": " << strerror(errno) << std::endl;
+        unlink(temporary.c_str());
+        return false;
+    }
+
+    data = static_cast<unsigned char*>(address);
+    size = bytes;
+    shared = true;
+    this->filename = filename;
+    targetName = target;
+    temporaryName = temporary;
+    return true;
+}
+
+bool mappedFile::commit() {
+    if (!shared || temporaryName.empty()) {
+        return shared;
+    }
+    if (rename(temporaryName.c_str(), targetName.c_str()) != 0) {
+        std::cerr << "Error: No se pudo guardar " << filename << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    temporaryName.clear();
+    return true;
+}
+
+void mappedFile::close() {
+    if (data) {
+        munmap(data, size);
+        data = nullptr;
+        size = 0;
+        shared = false;
+        filename.clear();
+    }
+    // Salida que no llegó a guardarse: el destino queda como estaba
+    if (!temporaryName.empty()) {
+        unlink(temporaryName.c_str());
+        temporaryName.clear();
+    }
+    targetName.clear();
+}
+
+bool mappedFile::sameFile(const char* first, const char* second) {
+    struct stat firstInfo, secondInfo;
+    if (stat(first, &firstInfo) != 0 || stat(second, &secondInfo) != 0) {
+        return false;
+    }
+    return firstInfo.st_dev == secondInfo.st_dev && firstInfo.st_ino == secondInfo.st_ino;
+}
+
+void mappedFile::adviseSequential() {
+    if (data) {
+        madvise(data, size, MADV_SEQUENTIAL);
+    }
+}
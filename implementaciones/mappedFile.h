@@ -0,0 +1,51 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Proyección de un archivo completo en memoria (mmap). Las páginas se leen
+// bajo demanda desde la caché del sistema.
+//  - open: proyección privada de un archivo existente; escribir en ella crea
+//    una copia privada (copy-on-write) y nunca modifica el archivo.
+//  - create: archivo temporal de bytes bytes (ftruncate) en el directorio de
+//    filename, proyectado de forma compartida; lo que se escribe en la memoria
+//    es el contenido del archivo. commit lo renombra a filename, así que el
+//    destino no se toca hasta que la salida está completa (aunque sea el mismo
+//    archivo que una entrada proyectada). Sin commit, close lo borra.
+class mappedFile {
+public:
+    mappedFile();
+    ~mappedFile();
+
+    bool open(const char* filename);
+    bool create(const char* filename, size_t bytes);
+    bool commit();
+    void close();
+    // Indica al núcleo que las páginas se recorrerán en orden
+    void adviseSequential();
+
+    bool isOpen() const { return data != nullptr; }
+    unsigned char* getData() const { return data; }
+    size_t getSize() const { return size; }
+    // Archivo creado con create (las escrituras llegan al disco)
+    bool isShared() const { return shared; }
+    const char* getFilename() const { return filename.c_str(); }
+
+    // Ambas rutas existen y son el mismo archivo (mismo dispositivo e inodo),
+    // aunque se escriban distinto ("./a.pgm", ruta absoluta, enlace simbólico)
+    static bool sameFile(const char* first, const char* second);
+
+private:
+    unsigned char* data;
+    size_t size;
+    bool shared;
+    std::string filename;
+    std::string targetName;    // filename resuelto (enlaces simbólicos)
+    std::string temporaryName; // Archivo de create aún sin renombrar
+
+    mappedFile(const mappedFile&);
+    mappedFile& operator=(const mappedFile&);
+};
+
+#endif
@@ -8,40 +8,13 @@
 #include "image.h"
 #include "imagesPGM.h"
 #include "imagesPPM.h"
+#include "imageFactory.h"
 #include "filter.h"
 #include "blurFilter.h"
 #include "laplaceFilter.h"
 #include "sharpenFilter.h"
 #include "timer.h"
 
-// Función para detectar el tipo de archivo por número mágico
-Image* createImageFromFile(const char* filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        return nullptr;
-    }
-    
-    char magicNumber[3];
-    file >> magicNumber;
-    file.close();
-    
-    if (strcmp(magicNumber, "P2") == 0) {
-        imagesPGM* img = new imagesPGM();
-        if (img->loadFromFile(filename)) {
-            return img;
-        }
-        delete img;
-    } else if (strcmp(magicNumber, "P3") == 0) {
-        imagesPPM* img = new imagesPPM();
-        if (img->loadFromFile(filename)) {
-            return img;
-        }
-        delete img;
-    }
-    
-    return nullptr;
-}
-
 // Crear filtro basado en el nombre
 filter* createFilter(const char* filterName) {
     if (strcmp(filterName, "blur") == 0) {
@@ -54,20 +27,36 @@ filter* createFilter(const char* filterName) {
     return nullptr;
 }
 
-// Aplicar filtro MPI a una región específica
-void applyFilterMPI(Image* input, Image* output, const char* filterName, int startY, int endY, int rank) {
+// Vista de un canal completo de la imagen cargada en el nodo 0
+static imageView channelView(Image* image, int channel) {
+    if (image->isGrayscale()) {
+        return dynamic_cast<imagesPGM*>(image)->getView();
+    }
+    return dynamic_cast<imagesPPM*>(image)->getChannelView(channel);
+}
+
+// Un vecino existe si cae dentro de la franja o de su halo; el halo de cada
+// franja termina justo en el borde real de la imagen
+static bool hasNeighbor(const imageView& view, int x, int y) {
+    return x >= -view.haloLeft && x < view.width + view.haloRight &&
+           y >= -view.haloTop && y < view.height + view.haloBottom;
+}
+
+// Aplicar filtro MPI a una franja (vistas por canal; coordenadas relativas a la franja)
+void applyFilterMPI(const imageView* input, const imageView* output, int channels, int maxValue,
+                    const char* filterName, int startY, int endY, int rank) {
     timer regionTimer;
     regionTimer.start();
     
     std::cout << "Nodo " << rank << " procesando región Y=" << startY << " a " << endY-1 << std::endl;
     
-    if (strcmp(input->getMagicNumber(), "P2") == 0) {
-        imagesPGM* pgmInput = dynamic_cast<imagesPGM*>(input);
-        imagesPGM* pgmOutput = dynamic_cast<imagesPGM*>(output);
+    for (int c = 0; c < channels; c++) {
+        const imageView& in = input[c];
+        const imageView& out = output[c];
         
         // Aplicar filtro solo a la región asignada
-        for (int y = startY; y < endY; y++) {
-            for (int x = 0; x < input->getWidth(); x++) {
+        for (int y = 0; y < in.height; y++) {
+            for (int x = 0; x < in.width; x++) {
                 int newValue = 0;
                 
                 if (strcmp(filterName, "blur") == 0) {
@@ -76,76 +65,40 @@ void applyFilterMPI(Image* input, Image* output, const char* filterName, int sta
                     for (int dy = -1; dy <= 1; dy++) {
                         for (int dx = -1; dx <= 1; dx++) {
                             int ny = y + dy, nx = x + dx;
-                            if (ny >= 0 && ny < input->getHeight() && 
-                                nx >= 0 && nx < input->getWidth()) {
-                                sum += pgmInput->getPixel(nx, ny);
+                            if (hasNeighbor(in, nx, ny)) {
+                                sum += in.sample(nx, ny);
                                 count++;
                             }
                         }
                     }
-                    newValue = count > 0 ? sum / count : pgmInput->getPixel(x, y);
+                    newValue = count > 0 ? sum / count : in.sample(x, y);
                     
                 } else if (strcmp(filterName, "laplace") == 0) {
                     // Kernel Laplace
-                    int sum = pgmInput->getPixel(x, y) * 4;
-                    if (y > 0) sum -= pgmInput->getPixel(x, y-1);
-                    if (y < input->getHeight()-1) sum -= pgmInput->getPixel(x, y+1);
-                    if (x > 0) sum -= pgmInput->getPixel(x-1, y);
-                    if (x < input->getWidth()-1) sum -= pgmInput->getPixel(x+1, y);
+                    int sum = in.sample(x, y) * 4;
+                    if (hasNeighbor(in, x, y-1)) sum -= in.sample(x, y-1);
+                    if (hasNeighbor(in, x, y+1)) sum -= in.sample(x, y+1);
+                    if (hasNeighbor(in, x-1, y)) sum -= in.sample(x-1, y);
+                    if (hasNeighbor(in, x+1, y)) sum -= in.sample(x+1, y);
                     
                     newValue = abs(sum);
-                    if (newValue > input->getMaxValue()) newValue = input->getMaxValue();
+                    if (newValue > maxValue) newValue = maxValue;
                     if (newValue < 0) newValue = 0;
                     
                 } else if (strcmp(filterName, "sharpen") == 0) {
                     // Kernel sharpen
-                    int sum = pgmInput->getPixel(x, y) * 5;
-                    if (y > 0) sum -= pgmInput->getPixel(x, y-1);
-                    if (y < input->getHeight()-1) sum -= pgmInput->getPixel(x, y+1);
-                    if (x > 0) sum -= pgmInput->getPixel(x-1, y);
-                    if (x < input->getWidth()-1) sum -= pgmInput->getPixel(x+1, y);
+                    int sum = in.sample(x, y) * 5;
+                    if (hasNeighbor(in, x, y-1)) sum -= in.sample(x, y-1);
+                    if (hasNeighbor(in, x, y+1)) sum -= in.sample(x, y+1);
+                    if (hasNeighbor(in, x-1, y)) sum -= in.sample(x-1, y);
+                    if (hasNeighbor(in, x+1, y)) sum -= in.sample(x+1, y);
                     
                     newValue = sum;
-                    if (newValue > input->getMaxValue()) newValue = input->getMaxValue();
+                    if (newValue > maxValue) newValue = maxValue;
                     if (newValue < 0) newValue = 0;
                 }
                 
-                pgmOutput->setPixel(x, y, newValue);
-            }
-        }
-    } else if (strcmp(input->getMagicNumber(), "P3") == 0) {
-        imagesPPM* ppmInput = dynamic_cast<imagesPPM*>(input);
-        imagesPPM* ppmOutput = dynamic_cast<imagesPPM*>(output);
-        
-        // Aplicar filtro a región PPM (simplificado)
-        for (int y = startY; y < endY; y++) {
-            for (int x = 0; x < input->getWidth(); x++) {
-                RGB pixel = ppmInput->getPixel(x, y);
-                
-                if (strcmp(filterName, "blur") == 0) {
-                    // Aplicar blur simple a cada canal
-                    int sumR = 0, sumG = 0, sumB = 0, count = 0;
-                    for (int dy = -1; dy <= 1; dy++) {
-                        for (int dx = -1; dx <= 1; dx++) {
-                            int ny = y + dy, nx = x + dx;
-                            if (ny >= 0 && ny < input->getHeight() && 
-                                nx >= 0 && nx < input->getWidth()) {
-                                RGB neighbor = ppmInput->getPixel(nx, ny);
-                                sumR += neighbor.r;
-                                sumG += neighbor.g;
-                                sumB += neighbor.b;
-                                count++;
-                            }
-                        }
-                    }
-                    if (count > 0) {
-                        pixel.r = sumR / count;
-                        pixel.g = sumG / count;
-                        pixel.b = sumB / count;
-                    }
-                }
-                
-                ppmOutput->setPixel(x, y, pixel);
+                out.putSample(x, y, newValue);
             }
         }
     }
@@ -199,32 +152,48 @@ int main(int argc, char* argv[]) {
     timer totalTimer;
     totalTimer.start();
     
-    // Enfoque simplificado: cada nodo carga la imagen completa
-    Image* inputImage = createImageFromFile(inputFile);
-    if (!inputImage) {
-        std::cerr << "Nodo " << rank << ": Error al cargar imagen " << inputFile << std::endl;
-        MPI_Finalize();
-        return 1;
+    // Solo el nodo 0 carga la imagen; los demás reciben únicamente su franja
+    Image* inputImage = nullptr;
+    Image* finalImage = nullptr;
+    // Cabecera compartida: canales, ancho, alto, valor máximo, bytes por muestra, stride
+    int header[6] = {0, 0, 0, 0, 0, 0};
+    if (rank == 0) {
+        imageLoadOptions options;
+        options.memoryMapped = true;
+        inputImage = imageFactory::load(inputFile, options);
+        if (inputImage) {
+            // La imagen final recibe directamente las franjas de todos los nodos;
+            // solo se copia la cabecera, todas sus filas se sobrescriben
+            bool isPGM = inputImage->isGrayscale();
+            if (isPGM) {
+                finalImage = dynamic_cast<imagesPGM*>(inputImage)->createLike();
+            } else {
+                finalImage = dynamic_cast<imagesPPM*>(inputImage)->createLike();
+            }
+            header[0] = isPGM ? 1 : 3;
+            header[1] = inputImage->getWidth();
+            header[2] = inputImage->getHeight();
+            header[3] = inputImage->getMaxValue();
+            header[4] = inputImage->getSampleBytes();
+            header[5] = isPGM ? dynamic_cast<imagesPGM*>(inputImage)->getStride()
+                              : dynamic_cast<imagesPPM*>(inputImage)->getStride();
+        } else {
+            std::cerr << "Nodo " << rank << ": Error al cargar imagen " << inputFile << std::endl;
+        }
     }
+    MPI_Bcast(header, 6, MPI_INT, 0, MPI_COMM_WORLD);
     
-    // Crear imagen de salida copiando la entrada
-    Image* outputImage = nullptr;
-    if (strcmp(inputImage->getMagicNumber(), "P2") == 0) {
-        outputImage = new imagesPGM();
-        if (!outputImage->loadFromFile(inputFile)) {
-            std::cerr << "Nodo " << rank << ": Error al crear imagen de salida" << std::endl;
-            delete inputImage;
-            MPI_Finalize();
-            return 1;
-        }
-    } else if (strcmp(inputImage->getMagicNumber(), "P3") == 0) {
-        outputImage = new imagesPPM();
-        if (!outputImage->loadFromFile(inputFile)) {
-            std::cerr << "Nodo " << rank << ": Error al crear imagen de salida" << std::endl;
-            delete inputImage;
-            MPI_Finalize();
-            return 1;
-        }
+    int channels = header[0];
+    int width = header[1];
+    int height = header[2];
+    int maxValue = header[3];
+    int sampleBytes = header[4];
+    int stride = header[5];
+    if (channels == 0) {
+        delete inputImage;
+        delete finalImage;
+        MPI_Finalize();
+        return 1;
     }
     
     if (rank == 0) {
@@ -233,7 +202,7 @@ int main(int argc, char* argv[]) {
         std::cout << "Archivo de entrada: " << inputFile << std::endl;
         std::cout << "Archivo de salida: " << outputFile << std::endl;
         std::cout << "Filtro: " << filterName << std::endl;
-        std::cout << "Dimensiones: " << inputImage->getWidth() << "x" << inputImage->getHeight() << std::endl;
+        std::cout << "Dimensiones: " << width << "x" << height << std::endl;
         std::cout << "=======================================================" << std::endl;
     }
     
@@ -241,67 +210,84 @@ int main(int argc, char* argv[]) {
     MPI_Barrier(MPI_COMM_WORLD);
     
     // Dividir trabajo por filas
-    int rowsPerNode = inputImage->getHeight() / size;
+    int rowsPerNode = height / size;
     int startY = rank * rowsPerNode;
-    int endY = (rank == size - 1) ? inputImage->getHeight() : (rank + 1) * rowsPerNode;
+    int endY = (rank == size - 1) ? height : (rank + 1) * rowsPerNode;
+    size_t rowBytes = static_cast<size_t>(stride) * sampleBytes;
     
     std::cout << "Nodo " << rank << " procesará filas " << startY << " a " << endY-1 << std::endl;
     
+    // Vistas de la franja propia (una por canal) y memoria local de los trabajadores
+    imageView inputViews[3];
+    imageView outputViews[3];
+    std::vector<unsigned char> localInput;
+    std::vector<unsigned char> localOutput;
+    
+    if (rank == 0) {
+        // Repartir a cada nodo sus filas más una fila de halo por lado
+        // (cuando existe), enviadas directamente desde el buffer de la imagen
+        const unsigned char* base = channelView(inputImage, 0).data;
+        for (int i = 1; i < size; i++) {
+            int nodeStartY = i * rowsPerNode;
+            int nodeEndY = (i == size - 1) ? height : (i + 1) * rowsPerNode;
+            int haloTop = nodeStartY > 0 ? 1 : 0;
+            int haloBottom = nodeEndY < height ? 1 : 0;
+            int rows = nodeEndY - nodeStartY + haloTop + haloBottom;
+            MPI_Send(base + static_cast<size_t>(nodeStartY - haloTop) * rowBytes,
+                     static_cast<int>(rows * rowBytes), MPI_BYTE, i, 0, MPI_COMM_WORLD);
+        }
+        
+        // El nodo 0 trabaja sobre su franja sin copiarla
+        for (int c = 0; c < channels; c++) {
+            inputViews[c] = channelView(inputImage, c).region(0, startY, width, endY - startY);
+            outputViews[c] = channelView(finalImage, c).region(0, startY, width, endY - startY);
+        }
+    } else {
+        int haloTop = startY > 0 ? 1 : 0;
+        int haloBottom = endY < height ? 1 : 0;
+        int rows = endY - startY;
+        localInput.resize((rows + haloTop + haloBottom) * rowBytes);
+        localOutput.resize(rows * rowBytes);
+        MPI_Recv(localInput.data(), static_cast<int>(localInput.size()), MPI_BYTE, 0, 0,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        
+        // Canal c de la franja: muestras con paso 'channels' dentro de cada fila
+        for (int c = 0; c < channels; c++) {
+            inputViews[c] = imageView(localInput.data() + haloTop * rowBytes + c * sampleBytes,
+                                      width, rows, stride, channels, sampleBytes);
+            inputViews[c].haloTop = haloTop;
+            inputViews[c].haloBottom = haloBottom;
+            outputViews[c] = imageView(localOutput.data() + c * sampleBytes,
+                                       width, rows, stride, channels, sampleBytes);
+        }
+    }
+    
     // Aplicar filtro a la región asignada
     timer processTimer;
     processTimer.start();
     
-    applyFilterMPI(inputImage, outputImage, filterName, startY, endY, rank);
+    applyFilterMPI(inputViews, outputViews, channels, maxValue, filterName, startY, endY, rank);
     
     processTimer.stop();
     
     // Sincronizar antes de combinar resultados
     MPI_Barrier(MPI_COMM_WORLD);
     
-    // Estrategia simplificada: usar archivos temporales para combinar resultados
     if (rank == 0) {
         std::cout << "Combinando resultados de todos los nodos..." << std::endl;
         
-        // Crear imagen final
-        Image* finalImage = nullptr;
-        if (strcmp(inputImage->getMagicNumber(), "P2") == 0) {
-            finalImage = new imagesPGM();
-            finalImage->loadFromFile(inputFile); // Cargar estructura base
-        } else {
-            finalImage = new imagesPPM();
-            finalImage->loadFromFile(inputFile); // Cargar estructura base
-        }
-        
-        // Copiar región del nodo 0
-        if (strcmp(inputImage->getMagicNumber(), "P2") == 0) {
-            imagesPGM* pgmFinal = dynamic_cast<imagesPGM*>(finalImage);
-            imagesPGM* pgmOutput = dynamic_cast<imagesPGM*>(outputImage);
-            
-            for (int y = startY; y < endY; y++) {
-                for (int x = 0; x < inputImage->getWidth(); x++) {
-                    pgmFinal->setPixel(x, y, pgmOutput->getPixel(x, y));
-                }
-            }
-        }
-        
-        // Recibir resultados de otros nodos
+        // La franja del nodo 0 ya está en la imagen final; recibir las demás
+        unsigned char* base = channelView(finalImage, 0).data;
         for (int i = 1; i < size; i++) {
             int nodeStartY = i * rowsPerNode;
-            int nodeEndY = (i == size - 1) ? inputImage->getHeight() : (i + 1) * rowsPerNode;
+            int nodeEndY = (i == size - 1) ? height : (i + 1) * rowsPerNode;
             
             std::cout << "Recibiendo datos del nodo " << i << " (filas " << nodeStartY << "-" << nodeEndY-1 << ")" << std::endl;
             
-            if (strcmp(inputImage->getMagicNumber(), "P2") == 0) {
-                imagesPGM* pgmFinal = dynamic_cast<imagesPGM*>(finalImage);
-                
-                for (int y = nodeStartY; y < nodeEndY; y++) {
-                    for (int x = 0; x < inputImage->getWidth(); x++) {
-                        int pixel;
-                        MPI_Recv(&pixel, 1, MPI_INT, i, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                        pgmFinal->setPixel(x, y, pixel);
-                    }
-                }
-            }
+            // Un único mensaje por nodo, recibido directamente en el buffer final
+            MPI_Recv(base + static_cast<size_t>(nodeStartY) * rowBytes,
+                     static_cast<int>((nodeEndY - nodeStartY) * rowBytes), MPI_BYTE, i, 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
         }
         
         // Guardar imagen final
@@ -315,22 +301,11 @@ int main(int argc, char* argv[]) {
             std::cout << "Imagen final guardada en " << saveTimer.getElapsedMilliseconds() << " ms" << std::endl;
         }
         
-        delete finalImage;
-        
     } else {
         // Nodos trabajadores: enviar sus resultados al nodo 0
         std::cout << "Nodo " << rank << " enviando resultados al nodo maestro..." << std::endl;
         
-        if (strcmp(inputImage->getMagicNumber(), "P2") == 0) {
-            imagesPGM* pgmOutput = dynamic_cast<imagesPGM*>(outputImage);
-            
-            for (int y = startY; y < endY; y++) {
-                for (int x = 0; x < inputImage->getWidth(); x++) {
-                    int pixel = pgmOutput->getPixel(x, y);
-                    MPI_Send(&pixel, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
-                }
-            }
-        }
+        MPI_Send(localOutput.data(), static_cast<int>(localOutput.size()), MPI_BYTE, 0, 0, MPI_COMM_WORLD);
     }
     
     totalTimer.stop();
@@ -358,9 +333,9 @@ int main(int argc, char* argv[]) {
             metrics << "Input: " << inputFile << std::endl;
             metrics << "Output: " << outputFile << std::endl;
             metrics << "Nodes: " << size << std::endl;
-            metrics << "Image size: " << inputImage->getWidth() << "x" << inputImage->getHeight() << std::endl;
-            metrics << "Total pixels: " << (inputImage->getWidth() * inputImage->getHeight()) << std::endl;
-            metrics << "Pixels per node: " << (rowsPerNode * inputImage->getWidth()) << std::endl;
+            metrics << "Image size: " << width << "x" << height << std::endl;
+            metrics << "Total pixels: " << (width * height) << std::endl;
+            metrics << "Pixels per node: " << (rowsPerNode * width) << std::endl;
             metrics << "Total time: " << std::fixed << std::setprecision(3) << totalTime << " ms" << std::endl;
             metrics << "Processing time: " << std::fixed << std::setprecision(3) << processingTime << " ms" << std::endl;
             metrics << "Communication overhead: " << std::fixed << std::setprecision(3) << (totalTime - processingTime) << " ms" << std::endl;
@@ -376,7 +351,7 @@ int main(int argc, char* argv[]) {
     
     // Limpiar memoria
     delete inputImage;
-    delete outputImage;
+    delete finalImage;
     
     MPI_Finalize();
     return 0;
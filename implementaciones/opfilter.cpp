@@ -1,4 +1,6 @@
 #include "opfilter.h"
+#include "builtinKernels.h"
+#include "simdStencil.h"
 #include <iostream>
 #include <iomanip>
 #include <cmath>
@@ -6,156 +8,6 @@
 
 opfilter::opfilter(int threads) : numThreads(threads) {
     omp_set_num_threads(numThreads);
-    initializeKernels();
-}
-
-opfilter::~opfilter() {
-    cleanupKernels();
-}
-
-void opfilter::initializeKernels() {
-    // Kernel gaussiano 3x3 para blur
-    blurKernel = new int[9] {
-        1, 2, 1,
-        2, 4, 2,
-        1, 2, 1
-    };
-    blurKernelSum = 16;
-    
-    // Kernel Laplaciano 3x3 para detección de bordes
-    laplaceKernel = new int[9] {
-        0, -1,  0,
-       -1,  4, -1,
-        0, -1,  0
-    };
-    
-    // Kernel de realce 3x3
-    sharpenKernel = new int[9] {
-        0, -1,  0,
-       -1,  5, -1,
-        0, -1,  0
-    };
-}
-
-void opfilter::cleanupKernels() {
-    delete[] blurKernel;
-    delete[] laplaceKernel;
-    delete[] sharpenKernel;
-}
-
-int opfilter::clampValue(int value, int min, int max) {
-    if (value < min) return min;
-    if (value > max) return max;
-    return value;
-}
-
-int opfilter::getClampedPixel(imagesPGM* image, int x, int y) {
-    x = clampValue(x, 0, image->getWidth() - 1);
-    y = clampValue(y, 0, image->getHeight() - 1);
-    return image->getPixel(x, y);
-}
-
-RGB opfilter::getClampedPixelRGB(imagesPPM* image, int x, int y) {
-    x = clampValue(x, 0, image->getWidth() - 1);
-    y = clampValue(y, 0, image->getHeight() - 1);
-    return image->getPixel(x, y);
-}
-
-// Implementación de filtros para PGM
-int opfilter::applyBlurPGM(imagesPGM* input, int x, int y) {
-    int sum = 0;
-    for (int ky = -1; ky <= 1; ky++) {
-        for (int kx = -1; kx <= 1; kx++) {
-            int pixelValue = getClampedPixel(input, x + kx, y + ky);
-            int kernelIndex = (ky + 1) * 3 + (kx + 1);
-            sum += pixelValue * blurKernel[kernelIndex];
-        }
-    }
-    sum /= blurKernelSum;
-    return clampValue(sum, 0, input->getMaxValue());
-}
-
-int opfilter::applyLaplacePGM(imagesPGM* input, int x, int y) {
-    int sum = 0;
-    for (int ky = -1; ky <= 1; ky++) {
-        for (int kx = -1; kx <= 1; kx++) {
-            int pixelValue = getClampedPixel(input, x + kx, y + ky);
-            int kernelIndex = (ky + 1) * 3 + (kx + 1);
-            sum += pixelValue * laplaceKernel[kernelIndex];
-        }
-    }
-    sum = abs(sum);
-    return clampValue(sum, 0, input->getMaxValue());
-}
-
-int opfilter::applySharpenPGM(imagesPGM* input, int x, int y) {
-    int sum = 0;
-    for (int ky = -1; ky <= 1; ky++) {
-        for (int kx = -1; kx <= 1; kx++) {
-            int pixelValue = getClampedPixel(input, x + kx, y + ky);
-            int kernelIndex = (ky + 1) * 3 + (kx + 1);
-            sum += pixelValue * sharpenKernel[kernelIndex];
-        }
-    }
-    return clampValue(sum, 0, input->getMaxValue());
-}
-
-// Implementación de filtros para PPM
-RGB opfilter::applyBlurPPM(imagesPPM* input, int x, int y) {
-    int sumR = 0, sumG = 0, sumB = 0;
-    for (int ky = -1; ky <= 1; ky++) {
-        for (int kx = -1; kx <= 1; kx++) {
-            RGB pixel = getClampedPixelRGB(input, x + kx, y + ky);
-            int kernelIndex = (ky + 1) * 3 + (kx + 1);
-            int kernelValue = blurKernel[kernelIndex];
-            sumR += pixel.r * kernelValue;
-            sumG += pixel.g * kernelValue;
-            sumB += pixel.b * kernelValue;
-        }
-    }
-    sumR /= blurKernelSum;
-    sumG /= blurKernelSum;
-    sumB /= blurKernelSum;
-    return RGB(clampValue(sumR, 0, input->getMaxValue()),
-               clampValue(sumG, 0, input->getMaxValue()),
-               clampValue(sumB, 0, input->getMaxValue()));
-}
-
-RGB opfilter::applyLaplacePPM(imagesPPM* input, int x, int y) {
-    int sumR = 0, sumG = 0, sumB = 0;
-    for (int ky = -1; ky <= 1; ky++) {
-        for (int kx = -1; kx <= 1; kx++) {
-            RGB pixel = getClampedPixelRGB(input, x + kx, y + ky);
-            int kernelIndex = (ky + 1) * 3 + (kx + 1);
-            int kernelValue = laplaceKernel[kernelIndex];
-            sumR += pixel.r * kernelValue;
-            sumG += pixel.g * kernelValue;
-            sumB += pixel.b * kernelValue;
-        }
-    }
-    sumR = abs(sumR);
-    sumG = abs(sumG);
-    sumB = abs(sumB);
-    return RGB(clampValue(sumR, 0, input->getMaxValue()),
-               clampValue(sumG, 0, input->getMaxValue()),
-               clampValue(sumB, 0, input->getMaxValue()));
-}
-
-RGB opfilter::applySharpenPPM(imagesPPM* input, int x, int y) {
-    int sumR = 0, sumG = 0, sumB = 0;
-    for (int ky = -1; ky <= 1; ky++) {
-        for (int kx = -1; kx <= 1; kx++) {
-            RGB pixel = getClampedPixelRGB(input, x + kx, y + ky);
-            int kernelIndex = (ky + 1) * 3 + (kx + 1);
-            int kernelValue = sharpenKernel[kernelIndex];
-            sumR += pixel.r * kernelValue;
-            sumG += pixel.g * kernelValue;
-            sumB += pixel.b * kernelValue;
-        }
-    }
-    return RGB(clampValue(sumR, 0, input->getMaxValue()),
-               clampValue(sumG, 0, input->getMaxValue()),
-               clampValue(sumB, 0, input->getMaxValue()));
 }
 
 void opfilter::setNumThreads(int threads) {
@@ -170,6 +22,7 @@ void opfilter::printOpenMPInfo() const {
     std::cout << "Procesadores disponibles: " << omp_get_num_procs() << std::endl;
     std::cout << "Filtros a aplicar: blur, laplace, sharpen" << std::endl;
     std::cout << "Estrategia: 3 filtros en paralelo simultáneamente" << std::endl;
+    std::cout << "Instrucciones vectoriales: " << simdStencil::levelName(simdStencil::level()) << std::endl;
     
     #ifdef _OPENMP
         std::cout << "Soporte OpenMP: SÍ (versión " << _OPENMP << ")" << std::endl;
@@ -192,37 +45,19 @@ void opfilter::printSystemInfo() {
     std::cout << "===============================" << std::endl;
 }
 
-bool opfilter::applyAllFiltersPGM(imagesPGM* input, imagesPGM* blurOutput, imagesPGM* laplaceOutput, imagesPGM* sharpenOutput) {
-    if (!input || !blurOutput || !laplaceOutput || !sharpenOutput) {
-        std::cerr << "Error: Alguna imagen es nula en opfilter::applyAllFiltersPGM" << std::endl;
-        return false;
-    }
-    
-    int width = input->getWidth();
-    int height = input->getHeight();
-    
-    std::cout << "Aplicando 3 filtros en paralelo con OpenMP a imagen PGM de " 
-              << width << "x" << height << std::endl;
-    
-    printOpenMPInfo();
-    
-    std::cout << "\nIniciando procesamiento de 3 filtros en paralelo..." << std::endl;
-    
-    // Aplicar los 3 filtros EN PARALELO usando sections
+void opfilter::applySections(const imageView* input, const imageView* blurOutput,
+                             const imageView* laplaceOutput, const imageView* sharpenOutput,
+                             int channels, int maxValue, const char* typeTag) {
+    // Aplicar los 3 filtros EN PARALELO usando sections; cada sección
+    // recorre los canales como vistas independientes
     #pragma omp parallel sections
     {
         // Sección 1: Filtro Blur
         #pragma omp section
         {
-            std::cout << "Hilo " << omp_get_thread_num() << ": Iniciando filtro BLUR" << std::endl;
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    int blurValue = applyBlurPGM(input, x, y);
-                    blurOutput->setPixel(x, y, blurValue);
-                }
-                if (height > 10 && y % (height / 10) == 0) {
-                    std::cout << "BLUR progreso: " << (y * 100) / height << "%" << std::endl;
-                }
+            std::cout << "Hilo " << omp_get_thread_num() << ": Iniciando filtro BLUR" << typeTag << std::endl;
+            for (int c = 0; c < channels; c++) {
+                blurKernel::apply(input[c], blurOutput[c], maxValue);
             }
             std::cout << "Hilo " << omp_get_thread_num() << ": BLUR completado" << std::endl;
         }
@@ -230,15 +65,9 @@ bool opfilter::applyAllFiltersPGM(imagesPGM* input, imagesPGM* blurOutput, image
         // Sección 2: Filtro Laplace
         #pragma omp section
         {
-            std::cout << "Hilo " << omp_get_thread_num() << ": Iniciando filtro LAPLACE" << std::endl;
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    int laplaceValue = applyLaplacePGM(input, x, y);
-                    laplaceOutput->setPixel(x, y, laplaceValue);
-                }
-                if (height > 10 && y % (height / 10) == 0) {
-                    std::cout << "LAPLACE progreso: " << (y * 100) / height << "%" << std::endl;
-                }
+            std::cout << "Hilo " << omp_get_thread_num() << ": Iniciando filtro LAPLACE" << typeTag << std::endl;
+            for (int c = 0; c < channels; c++) {
+                laplaceKernel::apply(input[c], laplaceOutput[c], maxValue);
             }
             std::cout << "Hilo " << omp_get_thread_num() << ": LAPLACE completado" << std::endl;
         }
@@ -246,19 +75,38 @@ bool opfilter::applyAllFiltersPGM(imagesPGM* input, imagesPGM* blurOutput, image
         // Sección 3: Filtro Sharpen
         #pragma omp section
         {
-            std::cout << "Hilo " << omp_get_thread_num() << ": Iniciando filtro SHARPEN" << std::endl;
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    int sharpenValue = applySharpenPGM(input, x, y);
-                    sharpenOutput->setPixel(x, y, sharpenValue);
-                }
-                if (height > 10 && y % (height / 10) == 0) {
-                    std::cout << "SHARPEN progreso: " << (y * 100) / height << "%" << std::endl;
-                }
+            std::cout << "Hilo " << omp_get_thread_num() << ": Iniciando filtro SHARPEN" << typeTag << std::endl;
+            for (int c = 0; c < channels; c++) {
+                sharpenKernel::apply(input[c], sharpenOutput[c], maxValue);
             }
             std::cout << "Hilo " << omp_get_thread_num() << ": SHARPEN completado" << std::endl;
         }
     }
+}
+
+bool opfilter::applyAllFiltersPGM(imagesPGM* input, imagesPGM* blurOutput, imagesPGM* laplaceOutput, imagesPGM* sharpenOutput) {
+    if (!input || !blurOutput || !laplaceOutput || !sharpenOutput) {
+        std::cerr << "Error: Alguna imagen es nula en opfilter::applyAllFiltersPGM" << std::endl;
+        return false;
+    }
+    
+    std::cout << "Aplicando 3 filtros en paralelo con OpenMP a imagen PGM de " 
+              << input->getWidth() << "x" << input->getHeight() << std::endl;
+    
+    printOpenMPInfo();
+    
+    std::cout << "\nIniciando procesamiento de 3 filtros en paralelo..." << std::endl;
+    
+    imageView inputView = input->getView();
+    imageView blurView = blurOutput->getView();
+    imageView laplaceView = laplaceOutput->getView();
+    imageView sharpenView = sharpenOutput->getView();
+    applySections(&inputView, &blurView, &laplaceView, &sharpenView, 1, input->getMaxValue(), "");
+    
+    // Relleno actualizado: las salidas pueden usarse como entrada de otro filtro
+    blurOutput->fillHalo();
+    laplaceOutput->fillHalo();
+    sharpenOutput->fillHalo();
     
     std::cout << "Los 3 filtros PGM han sido aplicados en paralelo" << std::endl;
     return true;
@@ -270,67 +118,28 @@ bool opfilter::applyAllFiltersPPM(imagesPPM* input, imagesPPM* blurOutput, image
         return false;
     }
     
-    int width = input->getWidth();
-    int height = input->getHeight();
-    
     std::cout << "Aplicando 3 filtros en paralelo con OpenMP a imagen PPM de " 
-              << width << "x" << height << std::endl;
+              << input->getWidth() << "x" << input->getHeight()
+              << (input->isPlanar() ? " (planar)" : "") << std::endl;
     
     printOpenMPInfo();
     
     std::cout << "\nIniciando procesamiento de 3 filtros en paralelo..." << std::endl;
     
-    // Aplicar los 3 filtros EN PARALELO usando sections
-    #pragma omp parallel sections
-    {
-        // Sección 1: Filtro Blur
-        #pragma omp section
-        {
-            std::cout << "Hilo " << omp_get_thread_num() << ": Iniciando filtro BLUR (PPM)" << std::endl;
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    RGB blurValue = applyBlurPPM(input, x, y);
-                    blurOutput->setPixel(x, y, blurValue);
-                }
-                if (height > 10 && y % (height / 10) == 0) {
-                    std::cout << "BLUR progreso: " << (y * 100) / height << "%" << std::endl;
-                }
-            }
-            std::cout << "Hilo " << omp_get_thread_num() << ": BLUR completado" << std::endl;
-        }
-        
-        // Sección 2: Filtro Laplace
-        #pragma omp section
-        {
-            std::cout << "Hilo " << omp_get_thread_num() << ": Iniciando filtro LAPLACE (PPM)" << std::endl;
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    RGB laplaceValue = applyLaplacePPM(input, x, y);
-                    laplaceOutput->setPixel(x, y, laplaceValue);
-                }
-                if (height > 10 && y % (height / 10) == 0) {
-                    std::cout << "LAPLACE progreso: " << (y * 100) / height << "%" << std::endl;
-                }
-            }
-            std::cout << "Hilo " << omp_get_thread_num() << ": LAPLACE completado" << std::endl;
-        }
-        
-        // Sección 3: Filtro Sharpen
-        #pragma omp section
-        {
-            std::cout << "Hilo " << omp_get_thread_num() << ": Iniciando filtro SHARPEN (PPM)" << std::endl;
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    RGB sharpenValue = applySharpenPPM(input, x, y);
-                    sharpenOutput->setPixel(x, y, sharpenValue);
-                }
-                if (height > 10 && y % (height / 10) == 0) {
-                    std::cout << "SHARPEN progreso: " << (y * 100) / height << "%" << std::endl;
-                }
-            }
-            std::cout << "Hilo " << omp_get_thread_num() << ": SHARPEN completado" << std::endl;
-        }
+    // Vistas por canal: sirven igual para organización planar o intercalada
+    imageView inputViews[3], blurViews[3], laplaceViews[3], sharpenViews[3];
+    for (int c = 0; c < 3; c++) {
+        inputViews[c] = input->getChannelView(c);
+        blurViews[c] = blurOutput->getChannelView(c);
+        laplaceViews[c] = laplaceOutput->getChannelView(c);
+        sharpenViews[c] = sharpenOutput->getChannelView(c);
     }
+    applySections(inputViews, blurViews, laplaceViews, sharpenViews, 3, input->getMaxValue(), " (PPM)");
+    
+    // Relleno actualizado: las salidas pueden usarse como entrada de otro filtro
+    blurOutput->fillHalo();
+    laplaceOutput->fillHalo();
+    sharpenOutput->fillHalo();
     
     std::cout << "Los 3 filtros PPM han sido aplicados en paralelo" << std::endl;
     return true;
@@ -343,15 +152,15 @@ bool opfilter::applyAllFilters(Image* input, Image* blurOutput, Image* laplaceOu
     }
     
     // Verificar que todas las imágenes sean del mismo tipo
-    if (strcmp(input->getMagicNumber(), blurOutput->getMagicNumber()) != 0 ||
-        strcmp(input->getMagicNumber(), laplaceOutput->getMagicNumber()) != 0 ||
-        strcmp(input->getMagicNumber(), sharpenOutput->getMagicNumber()) != 0) {
+    if (input->isGrayscale() != blurOutput->isGrayscale() ||
+        input->isGrayscale() != laplaceOutput->isGrayscale() ||
+        input->isGrayscale() != sharpenOutput->isGrayscale()) {
         std::cerr << "Error: Todas las imágenes deben ser del mismo tipo" << std::endl;
         return false;
     }
     
     // Aplicar filtros según el tipo
-    if (strcmp(input->getMagicNumber(), "P2") == 0) {
+    if (input->isGrayscale()) {
         imagesPGM* pgmInput = dynamic_cast<imagesPGM*>(input);
         imagesPGM* pgmBlur = dynamic_cast<imagesPGM*>(blurOutput);
         imagesPGM* pgmLaplace = dynamic_cast<imagesPGM*>(laplaceOutput);
@@ -360,7 +169,7 @@ bool opfilter::applyAllFilters(Image* input, Image* blurOutput, Image* laplaceOu
         if (pgmInput && pgmBlur && pgmLaplace && pgmSharpen) {
             return applyAllFiltersPGM(pgmInput, pgmBlur, pgmLaplace, pgmSharpen);
         }
-    } else if (strcmp(input->getMagicNumber(), "P3") == 0) {
+    } else if (input->isColor()) {
         imagesPPM* ppmInput = dynamic_cast<imagesPPM*>(input);
         imagesPPM* ppmBlur = dynamic_cast<imagesPPM*>(blurOutput);
         imagesPPM* ppmLaplace = dynamic_cast<imagesPPM*>(laplaceOutput);
@@ -373,4 +182,69 @@ bool opfilter::applyAllFilters(Image* input, Image* blurOutput, Image* laplaceOu
     
     std::cerr << "Error: Tipo de imagen no soportado para multi-filtros" << std::endl;
     return false;
-}
\ No newline at end of file
+}
+
+bool opfilter::applyFilter(filter* engine, Image* input, Image* output) {
+    if (!engine || !input || !output) {
+        std::cerr << "Error: Filtro o imagen nulos en opfilter::applyFilter" << std::endl;
+        return false;
+    }
+    if (input->isGrayscale() != output->isGrayscale() || input->isColor() != output->isColor()) {
+        std::cerr << "Error: Las imágenes deben ser del mismo tipo" << std::endl;
+        return false;
+    }
+
+    // Vistas por canal: sirven igual para organización planar o intercalada
+    imageView inputViews[3], outputViews[3];
+    int channels = 0;
+    if (input->isGrayscale()) {
+        imagesPGM* pgmInput = dynamic_cast<imagesPGM*>(input);
+        imagesPGM* pgmOutput = dynamic_cast<imagesPGM*>(output);
+        if (pgmInput && pgmOutput) {
+            inputViews[0] = pgmInput->getView();
+            outputViews[0] = pgmOutput->getView();
+            channels = 1;
+        }
+    } else if (input->isColor()) {
+        imagesPPM* ppmInput = dynamic_cast<imagesPPM*>(input);
+        imagesPPM* ppmOutput = dynamic_cast<imagesPPM*>(output);
+        if (ppmInput && ppmOutput) {
+            for (int c = 0; c < 3; c++) {
+                inputViews[c] = ppmInput->getChannelView(c);
+                outputViews[c] = ppmOutput->getChannelView(c);
+            }
+            channels = 3;
+        }
+    }
+    if (channels == 0) {
+        std::cerr << "Error: Tipo de imagen no soportado para filtros" << std::endl;
+        return false;
+    }
+
+    int width = input->getWidth();
+    int height = input->getHeight();
+    int maxValue = input->getMaxValue();
+    // Varias franjas por hilo para equilibrar la carga
+    int bandCount = numThreads * 4;
+    if (bandCount > height) bandCount = height;
+    int bandRows = (height + bandCount - 1) / bandCount;
+    bandCount = (height + bandRows - 1) / bandRows;
+
+    std::cout << "Aplicando filtro " << engine->getName() << " (kernel " << engine->getKernelSize() << "x"
+              << engine->getKernelSize() << ") con OpenMP a imagen de " << width << "x" << height
+              << " en " << bandCount << " franjas de " << bandRows << " filas" << std::endl;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int band = 0; band < bandCount; band++) {
+        int y = band * bandRows;
+        int rows = height - y < bandRows ? height - y : bandRows;
+        for (int c = 0; c < channels; c++) {
+            engine->applyToView(inputViews[c].region(0, y, width, rows),
+                                outputViews[c].region(0, y, width, rows), maxValue);
+        }
+    }
+
+    // Relleno actualizado: la salida puede usarse como entrada de otro filtro
+    output->fillHalo();
+    return true;
+}
@@ -4,38 +4,21 @@
 #include "Image.h"
 #include "imagesPGM.h"
 #include "imagesPPM.h"
+#include "imageView.h"
+#include "filter.h"
 #include <omp.h>
 
 class opfilter {
 private:
     int numThreads;
     
-    // Kernels para los tres filtros
-    int* blurKernel;
-    int blurKernelSum;
-    int* laplaceKernel;
-    int* sharpenKernel;
-    
-    void initializeKernels();
-    void cleanupKernels();
-    
-    // Métodos auxiliares para manejo de bordes
-    int clampValue(int value, int min, int max);
-    int getClampedPixel(imagesPGM* image, int x, int y);
-    RGB getClampedPixelRGB(imagesPPM* image, int x, int y);
-    
-    // Aplicar filtros específicos a un píxel
-    int applyBlurPGM(imagesPGM* input, int x, int y);
-    int applyLaplacePGM(imagesPGM* input, int x, int y);
-    int applySharpenPGM(imagesPGM* input, int x, int y);
-    
-    RGB applyBlurPPM(imagesPPM* input, int x, int y);
-    RGB applyLaplacePPM(imagesPPM* input, int x, int y);
-    RGB applySharpenPPM(imagesPPM* input, int x, int y);
+    // Aplica los tres filtros en paralelo (secciones OpenMP) sobre vistas por canal
+    void applySections(const imageView* input, const imageView* blurOutput,
+                       const imageView* laplaceOutput, const imageView* sharpenOutput,
+                       int channels, int maxValue, const char* typeTag);
     
 public:
     opfilter(int threads = 4);
-    ~opfilter();
 
     // Aplicar los tres filtros en paralelo
     bool applyAllFiltersPGM(imagesPGM* input, imagesPGM* blurOutput, imagesPGM* laplaceOutput, imagesPGM* sharpenOutput);
@@ -43,6 +26,11 @@ public:
 
     // Método general que detecta el tipo
     bool applyAllFilters(Image* input, Image* blurOutput, Image* laplaceOutput, Image* sharpenOutput);
+
+    // Un solo filtro (por ejemplo un kernel NxN del usuario) repartido entre
+    // los hilos por franjas de filas; cada franja lee del halo las filas
+    // vecinas que necesita, sin copias
+    bool applyFilter(filter* engine, Image* input, Image* output);
     
     // Configuración
     void setNumThreads(int threads);
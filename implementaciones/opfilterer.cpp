@@ -7,46 +7,50 @@
 #include "Image.h"
 #include "imagesPGM.h"
 #include "imagesPPM.h"
+#include "imageFactory.h"
+#include "compressedOutput.h"
 #include "filter.h"
 #include "blurFilter.h"
 #include "laplaceFilter.h"
 #include "sharpenFilter.h"
+#include "convolutionFilter.h"
+#include "opfilter.h"
 #include "Timer.h"
 
-// Detectar tipo de archivo por número mágico
-Image* createImageFromFile(const char* filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: No se puede abrir el archivo " << filename << std::endl;
-        return nullptr;
-    }
-
-    char magicNumber[3];
-    file >> magicNumber;
-    file.close();
-
-    if (strcmp(magicNumber, "P2") == 0) return new imagesPGM();
-    if (strcmp(magicNumber, "P3") == 0) return new imagesPPM();
-
-    std::cerr << "Error: Formato no soportado. Número mágico: " << magicNumber << std::endl;
-    return nullptr;
-}
-
-Image* createOutputImage(Image* input) {
+// Solo cabecera y geometría (los filtros sobrescriben todos los píxeles);
+// el primer acceso a las páginas se reparte entre los hilos OpenMP
+// Con P5/P6 de 8 bits los píxeles de salida se proyectan sobre outputFile
+// (si no es nullptr): el filtro escribe cada fila en su lugar definitivo de
+// un temporal que al guardar se renombra a outputFile, así que outputFile
+// puede ser el mismo archivo que la entrada proyectada
+Image* createOutputImage(Image* input, const char* outputFile) {
     if (!input) return nullptr;
 
-    if (strcmp(input->getMagicNumber(), "P2") == 0) {
+    if (input->isGrayscale()) {
         imagesPGM* pgmInput = dynamic_cast<imagesPGM*>(input);
-        if (pgmInput) return pgmInput->clone();
-    } else if (strcmp(input->getMagicNumber(), "P3") == 0) {
+        if (pgmInput) {
+            imagesPGM* mapped = outputFile ? pgmInput->createMappedOutput(outputFile) : nullptr;
+            return mapped ? mapped : pgmInput->createLike(true);
+        }
+    } else if (input->isColor()) {
         imagesPPM* ppmInput = dynamic_cast<imagesPPM*>(input);
-        if (ppmInput) return ppmInput->clone();
+        if (ppmInput) {
+            imagesPPM* mapped = outputFile ? ppmInput->createMappedOutput(outputFile) : nullptr;
+            return mapped ? mapped : ppmInput->createLike(true);
+        }
     }
     return nullptr;
 }
 
+// "lena.pgm" -> "lena_blur.pgm"; con salida comprimida "lena.pgm.gz" -> "lena_blur.pgm.gz"
 char* generateOutputFilename(const char* baseFilename, const char* filterSuffix) {
     const char* dot = strrchr(baseFilename, '.');
+    if (dot && dot > baseFilename && imageOutput::isCompressedName(baseFilename)) {
+        // La extensión es la de la imagen más ".gz"
+        const char* imageDot = dot - 1;
+        while (imageDot > baseFilename && *imageDot != '.' && *imageDot != '/') imageDot--;
+        if (*imageDot == '.') dot = imageDot;
+    }
     if (!dot) {
         char* result = new char[strlen(baseFilename) + strlen(filterSuffix) + 10];
         sprintf(result, "%s_%s", baseFilename, filterSuffix);
@@ -71,6 +75,62 @@ void printUsage(const char* programName) {
     std::cout << "  - <base>_blur.<ext>" << std::endl;
     std::cout << "  - <base>_laplace.<ext>" << std::endl;
     std::cout << "  - <base>_sharpen.<ext>" << std::endl;
+    std::cout << "Con <salida_base> terminada en .gz las salidas se comprimen con gzip" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Uso con un kernel NxN propio: " << programName << " <entrada> <salida> --k <kernel>" << std::endl;
+    std::cout << "Ejemplo: " << programName << " lena.pgm lena_gauss5.pgm --k gauss5.txt" << std::endl;
+    std::cout << "El kernel (N impar) viene de un archivo o como lista de coeficientes por" << std::endl;
+    std::cout << "filas; \"divisor N\" y \"offset N\" son opcionales. La imagen se reparte" << std::endl;
+    std::cout << "por franjas de filas entre los hilos OpenMP" << std::endl;
+}
+
+// Un solo kernel del usuario con todos los hilos OpenMP (franjas de filas)
+int runKernel(const char* inputFile, const char* outputFile, const char* kernelArgument) {
+    convolutionKernel kernel;
+    if (!kernel.load(kernelArgument)) {
+        return 1;
+    }
+    convolutionFilter engine(kernel);
+
+    // Relleno replicado del radio del kernel; planar: un canal a la vez
+    imageLoadOptions options;
+    options.halo = kernel.getRadius();
+    options.memoryMapped = true;
+    options.layout = PPM_PLANAR;
+    Image* inputImage = imageFactory::load(inputFile, options);
+    if (!inputImage) {
+        std::cerr << "Error cargando imagen " << inputFile << std::endl;
+        return 1;
+    }
+    Image* outputImage = createOutputImage(inputImage, outputFile);
+    if (!outputImage) {
+        std::cerr << "Error: No se pudo crear la imagen de salida " << outputFile << std::endl;
+        delete inputImage;
+        return 1;
+    }
+
+    std::cout << "Kernel " << kernel.getSize() << "x" << kernel.getSize() << ", divisor "
+              << kernel.getDivisor() << ", desplazamiento " << kernel.getOffset() << std::endl;
+
+    opfilter parallel(omp_get_max_threads());
+    timer filterTimer;
+    filterTimer.start();
+    bool success = parallel.applyFilter(&engine, inputImage, outputImage);
+    filterTimer.stop();
+    filterTimer.printElapsedTime("Tiempo del filtro OpenMP");
+
+    if (success && !outputImage->saveToFile(outputFile)) {
+        std::cerr << "Error: No se pudo guardar " << outputFile << std::endl;
+        success = false;
+    }
+    if (success) {
+        std::cout << "Archivo generado: " << outputFile << std::endl;
+    }
+
+    delete inputImage;
+    delete outputImage;
+    bufferPool::instance().printStatistics();
+    return success ? 0 : 1;
 }
 
 int main(int argc, char* argv[]) {
@@ -78,6 +138,9 @@ int main(int argc, char* argv[]) {
         printUsage(argv[0]);
         return 1;
     }
+    if (argc == 5 && strcmp(argv[3], "--k") == 0) {
+        return runKernel(argv[1], argv[2], argv[4]);
+    }
 
     const char* inputFile = argv[1];
     const char* outputBase = argv[2];
@@ -88,16 +151,46 @@ int main(int argc, char* argv[]) {
     char* sharpenFile = generateOutputFilename(outputBase, "sharpen");
 
     // Cargar imagen de entrada
-    Image* inputImage = createImageFromFile(inputFile);
-    if (!inputImage || !inputImage->loadFromFile(inputFile)) {
+    // Relleno replicado del radio del kernel 3x3: los filtros leen los
+    // vecinos del borde sin recortar coordenadas. Las entradas P5/P6 de 8 bits
+    // se usan sin copiar desde la proyección del archivo (entonces sin relleno)
+    imageLoadOptions options;
+    options.halo = 1;
+    options.memoryMapped = true;
+    // Organización planar: los filtros procesan un canal a la vez (una P6 de
+    // 8 bits proyectada queda intercalada, tal como está en el archivo)
+    options.layout = PPM_PLANAR;
+    Image* inputImage = imageFactory::load(inputFile, options);
+    if (!inputImage) {
         std::cerr << "Error cargando imagen " << inputFile << std::endl;
         return 1;
     }
 
     // Crear imágenes de salida
-    Image* blurOutput = createOutputImage(inputImage);
-    Image* laplaceOutput = createOutputImage(inputImage);
-    Image* sharpenOutput = createOutputImage(inputImage);
+    // Cada hilo escribe su resultado directamente en su archivo de salida
+    Image* blurOutput = createOutputImage(inputImage, blurFile);
+    Image* laplaceOutput = createOutputImage(inputImage, laplaceFile);
+    Image* sharpenOutput = createOutputImage(inputImage, sharpenFile);
+    const char* outputFiles[3] = { blurFile, laplaceFile, sharpenFile };
+    Image* outputs[3] = { blurOutput, laplaceOutput, sharpenOutput };
+    bool created = true;
+    for (int i = 0; i < 3; i++) {
+        if (!outputs[i]) {
+            std::cerr << "Error: No se pudo crear la imagen de salida " << outputFiles[i] << std::endl;
+            created = false;
+        }
+    }
+    if (!created) {
+        delete inputImage;
+        delete blurOutput;
+        delete laplaceOutput;
+        delete sharpenOutput;
+        delete[] blurFile;
+        delete[] laplaceFile;
+        delete[] sharpenFile;
+        return 1;
+    }
+    bool applied[3] = { false, false, false };
 
     timer filterTimer;
     filterTimer.start();
@@ -109,19 +202,19 @@ int main(int argc, char* argv[]) {
         {
             std::cout << "[Thread " << omp_get_thread_num() << "] Aplicando Blur..." << std::endl;
             blurFilter blur;
-            blur.apply(inputImage, blurOutput);
+            applied[0] = blur.apply(inputImage, blurOutput);
         }
         #pragma omp section
         {
             std::cout << "[Thread " << omp_get_thread_num() << "] Aplicando Laplace..." << std::endl;
             laplaceFilter laplace;
-            laplace.apply(inputImage, laplaceOutput);
+            applied[1] = laplace.apply(inputImage, laplaceOutput);
         }
         #pragma omp section
         {
             std::cout << "[Thread " << omp_get_thread_num() << "] Aplicando Sharpen..." << std::endl;
             sharpenFilter sharpen;
-            sharpen.apply(inputImage, sharpenOutput);
+            applied[2] = sharpen.apply(inputImage, sharpenOutput);
         }
     }
 
@@ -130,23 +223,35 @@ int main(int argc, char* argv[]) {
 
     // Guardar resultados
     std::cout << "Guardando resultados..." << std::endl;
-    blurOutput->saveToFile(blurFile);
-    laplaceOutput->saveToFile(laplaceFile);
-    sharpenOutput->saveToFile(sharpenFile);
+    // Una salida proyectada sin guardar no llega a su destino
+    bool saved[3];
+    bool success = true;
+    for (int i = 0; i < 3; i++) {
+        saved[i] = applied[i] && outputs[i]->saveToFile(outputFiles[i]);
+        if (!saved[i]) {
+            std::cerr << "Error: No se pudo generar " << outputFiles[i] << std::endl;
+            success = false;
+        }
+    }
 
     std::cout << "Archivos generados:" << std::endl;
-    std::cout << "  - " << blurFile << std::endl;
-    std::cout << "  - " << laplaceFile << std::endl;
-    std::cout << "  - " << sharpenFile << std::endl;
+    for (int i = 0; i < 3; i++) {
+        if (saved[i]) {
+            std::cout << "  - " << outputFiles[i] << std::endl;
+        }
+    }
 
     // Liberar memoria
     delete inputImage;
     delete blurOutput;
     delete laplaceOutput;
     delete sharpenOutput;
+
+    // Los buffers liberados quedan en el pool para el siguiente trabajo
+    bufferPool::instance().printStatistics();
     delete[] blurFile;
     delete[] laplaceFile;
     delete[] sharpenFile;
 
-    return 0;
+    return success ? 0 : 1;
 }
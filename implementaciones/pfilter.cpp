@@ -3,12 +3,11 @@
 #include "Timer.h"
 #include <iostream>
 #include <iomanip>
-#include <cstring>
 
 pfilter::pfilter(const char* name, int size) : filter(name, size) {
     // Inicializar datos de hilos
     for (int i = 0; i < NUM_THREADS; i++) {
-        memset(&threadData[i], 0, sizeof(ThreadData));
+        threadData[i] = ThreadData();
         threadData[i].threadId = i;
         threadData[i].filter = this;
     }
@@ -71,61 +70,20 @@ void pfilter::printRegionInfo() {
     std::cout << "==========================================" << std::endl;
 }
 
-void* pfilter::threadWorkerPGM(void* arg) {
+void* pfilter::threadWorker(void* arg) {
     ThreadData* data = static_cast<ThreadData*>(arg);
     
-    std::cout << "Hilo " << data->threadId << " iniciado para región PGM" << std::endl;
+    std::cout << "Hilo " << data->threadId << " iniciado para región de " 
+              << data->channels << " canal(es)" << std::endl;
     
     timer threadTimer;
     threadTimer.start();
     
-    // Convertir las imágenes al tipo correcto
-    imagesPGM* pgmInput = dynamic_cast<imagesPGM*>(data->inputImage);
-    imagesPGM* pgmOutput = dynamic_cast<imagesPGM*>(data->outputImage);
-
-    if (!pgmInput || !pgmOutput) {
-        std::cerr << "Error: Conversión de imagen fallida en hilo " << data->threadId << std::endl;
-        data->processingTime = 0;
-        pthread_exit(nullptr);
-    }
-    
-    // Procesar la región asignada
-    data->filter->processRegionPGM(pgmInput, pgmOutput, 
-                                   data->startX, data->endX, 
-                                   data->startY, data->endY);
-    
-    threadTimer.stop();
-    data->processingTime = threadTimer.getElapsedMilliseconds();
-    
-    std::cout << "Hilo " << data->threadId << " completado en " 
-              << std::fixed << std::setprecision(3) << data->processingTime << " ms" << std::endl;
-    
-    pthread_exit(nullptr);
-}
-
-void* pfilter::threadWorkerPPM(void* arg) {
-    ThreadData* data = static_cast<ThreadData*>(arg);
-    
-    std::cout << "Hilo " << data->threadId << " iniciado para región PPM" << std::endl;
-
-    timer threadTimer;
-    threadTimer.start();
-    
-    // Convertir las imágenes al tipo correcto
-    imagesPPM* ppmInput = dynamic_cast<imagesPPM*>(data->inputImage);
-    imagesPPM* ppmOutput = dynamic_cast<imagesPPM*>(data->outputImage);
-
-    if (!ppmInput || !ppmOutput) {
-        std::cerr << "Error: Conversión de imagen fallida en hilo " << data->threadId << std::endl;
-        data->processingTime = 0;
-        pthread_exit(nullptr);
+    // Procesar la región asignada, un canal a la vez
+    for (int c = 0; c < data->channels; c++) {
+        data->filter->applyToView(data->inputRegion[c], data->outputRegion[c], data->maxValue);
     }
     
-    // Procesar la región asignada
-    data->filter->processRegionPPM(ppmInput, ppmOutput, 
-                                   data->startX, data->endX, 
-                                   data->startY, data->endY);
-    
     threadTimer.stop();
     data->processingTime = threadTimer.getElapsedMilliseconds();
     
@@ -135,33 +93,29 @@ void* pfilter::threadWorkerPPM(void* arg) {
     pthread_exit(nullptr);
 }
 
-bool pfilter::applyToPGM(imagesPGM* input, imagesPGM* output) {
-    if (!input || !output) {
-        std::cerr << "Error: Imágenes nulas en pfilter::applyToPGM" << std::endl;
-        return false;
-    }
-    
-    int width = input->getWidth();
-    int height = input->getHeight();
-    
-    std::cout << "Aplicando filtro " << filterName << " con pthreads a imagen PGM de " 
-              << width << "x" << height << std::endl;
-    
+bool pfilter::runThreads(const imageView* input, const imageView* output, int channels, int maxValue) {
     // Calcular regiones para cada hilo
-    calculateRegions(width, height);
+    calculateRegions(input[0].width, input[0].height);
     printRegionInfo();
     
-    // Configurar datos para cada hilo
+    // Configurar datos para cada hilo: vistas del cuadrante, sin copiar píxeles
     for (int i = 0; i < NUM_THREADS; i++) {
-        threadData[i].inputImage = input;
-        threadData[i].outputImage = output;
+        ThreadData& data = threadData[i];
+        int regionWidth = data.endX - data.startX;
+        int regionHeight = data.endY - data.startY;
+        for (int c = 0; c < channels; c++) {
+            data.inputRegion[c] = input[c].region(data.startX, data.startY, regionWidth, regionHeight);
+            data.outputRegion[c] = output[c].region(data.startX, data.startY, regionWidth, regionHeight);
+        }
+        data.channels = channels;
+        data.maxValue = maxValue;
     }
     
     std::cout << "\nCreando " << NUM_THREADS << " hilos..." << std::endl;
     
     // Crear hilos
     for (int i = 0; i < NUM_THREADS; i++) {
-        int result = pthread_create(&threads[i], nullptr, threadWorkerPGM, &threadData[i]);
+        int result = pthread_create(&threads[i], nullptr, threadWorker, &threadData[i]);
         if (result != 0) {
             std::cerr << "Error creando hilo " << i << ": " << result << std::endl;
             return false;
@@ -185,54 +139,36 @@ bool pfilter::applyToPGM(imagesPGM* input, imagesPGM* output) {
     return true;
 }
 
-bool pfilter::applyToPPM(imagesPPM* input, imagesPPM* output) {
+bool pfilter::applyToPGM(imagesPGM* input, imagesPGM* output) {
     if (!input || !output) {
-        std::cerr << "Error: Imágenes nulas en pfilter::applyToPPM" << std::endl;
+        std::cerr << "Error: Imágenes nulas en pfilter::applyToPGM" << std::endl;
         return false;
     }
     
-    int width = input->getWidth();
-    int height = input->getHeight();
-    
-    std::cout << "Aplicando filtro " << filterName << " con pthreads a imagen PPM de " 
-              << width << "x" << height << std::endl;
-    
-    // Calcular regiones para cada hilo
-    calculateRegions(width, height);
-    printRegionInfo();
-    
-    // Configurar datos para cada hilo
-    for (int i = 0; i < NUM_THREADS; i++) {
-        threadData[i].inputImage = input;
-        threadData[i].outputImage = output;
-    }
-    
-    std::cout << "\nCreando " << NUM_THREADS << " hilos..." << std::endl;
+    std::cout << "Aplicando filtro " << filterName << " con pthreads a imagen PGM de " 
+              << input->getWidth() << "x" << input->getHeight() << std::endl;
     
-    // Crear hilos
-    for (int i = 0; i < NUM_THREADS; i++) {
-        int result = pthread_create(&threads[i], nullptr, threadWorkerPPM, &threadData[i]);
-        if (result != 0) {
-            std::cerr << "Error creando hilo " << i << ": " << result << std::endl;
-            return false;
-        }
+    imageView inputView = input->getView();
+    imageView outputView = output->getView();
+    return runThreads(&inputView, &outputView, 1, input->getMaxValue());
+}
+
+bool pfilter::applyToPPM(imagesPPM* input, imagesPPM* output) {
+    if (!input || !output) {
+        std::cerr << "Error: Imágenes nulas en pfilter::applyToPPM" << std::endl;
+        return false;
     }
     
-    std::cout << "Todos los hilos creados, esperando finalización..." << std::endl;
+    std::cout << "Aplicando filtro " << filterName << " con pthreads a imagen PPM de " 
+              << input->getWidth() << "x" << input->getHeight() << std::endl;
     
-    // Esperar a que terminen todos los hilos
-    for (int i = 0; i < NUM_THREADS; i++) {
-        int result = pthread_join(threads[i], nullptr);
-        if (result != 0) {
-            std::cerr << "Error esperando hilo " << i << ": " << result << std::endl;
-            return false;
-        }
+    imageView inputViews[3];
+    imageView outputViews[3];
+    for (int c = 0; c < 3; c++) {
+        inputViews[c] = input->getChannelView(c);
+        outputViews[c] = output->getChannelView(c);
     }
-    
-    std::cout << "Todos los hilos han terminado" << std::endl;
-    printThreadStatistics();
-    
-    return true;
+    return runThreads(inputViews, outputViews, 3, input->getMaxValue());
 }
 
 void pfilter::printThreadStatistics() {
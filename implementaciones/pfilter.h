@@ -6,11 +6,14 @@
 
 // Estructura para pasar datos a los hilos
 struct ThreadData {
-    // Imagen de entrada y salida
-    Image* inputImage;
-    Image* outputImage;
+    // Vistas del cuadrante sobre la imagen de entrada y salida (una por canal).
+    // No copian píxeles: apuntan directamente a los buffers de las imágenes
+    imageView inputRegion[3];
+    imageView outputRegion[3];
+    int channels;
+    int maxValue;
     
-    // Región de trabajo (cuadrante)
+    // Región de trabajo (cuadrante), en coordenadas de la imagen completa
     int startX;
     int endX;
     int startY;
@@ -37,11 +40,9 @@ private:
     void calculateRegions(int width, int height);
     void printRegionInfo();
     
-protected:
-    // Métodos virtuales que deben implementar las clases derivadas
-    virtual void processRegionPGM(imagesPGM* input, imagesPGM* output, int startX, int endX, int startY, int endY) = 0;
-    virtual void processRegionPPM(imagesPPM* input, imagesPPM* output, int startX, int endX, int startY, int endY) = 0;
-
+    // Reparte las vistas de canal completas en cuadrantes y lanza los hilos
+    bool runThreads(const imageView* input, const imageView* output, int channels, int maxValue);
+    
 public:
     pfilter(const char* name, int size = 3);
     virtual ~pfilter();
@@ -50,9 +51,9 @@ public:
     bool applyToPGM(imagesPGM* input, imagesPGM* output) override;
     bool applyToPPM(imagesPPM* input, imagesPPM* output) override;
     
-    // Funciones estáticas para los hilos
-    static void* threadWorkerPGM(void* arg);
-    static void* threadWorkerPPM(void* arg);
+    // Función estática para los hilos: cada uno aplica applyToView (definido
+    // por las clases derivadas) a su cuadrante de cada canal
+    static void* threadWorker(void* arg);
     
     // Métodos para obtener estadísticas
     void printThreadStatistics();
@@ -4,24 +4,11 @@
 #include "pfilter.h"
 
 class pfilterBlur : public pfilter {
-private:
-    int* kernel;
-    int kernelSum;
-    
-    void initializeKernel();
-    
-    // Métodos auxiliares para aplicar kernel en regiones
-    int applyKernelAtPosition(imagesPGM* image, int x, int y);
-    RGB applyKernelAtPositionRGB(imagesPPM* image, int x, int y);
-
 public:
     pfilterBlur();
-    ~pfilterBlur();
-    
-protected:
-    // Implementación de procesamiento de regiones
-    void processRegionPGM(imagesPGM* input, imagesPGM* output, int startX, int endX, int startY, int endY) override;
-    void processRegionPPM(imagesPPM* input, imagesPPM* output, int startX, int endX, int startY, int endY) override;
+
+    // Convolución de una región (el cuadrante de un hilo) de un canal
+    void applyToView(const imageView& input, const imageView& output, int maxValue) override;
 };
 
 #endif
\ No newline at end of file
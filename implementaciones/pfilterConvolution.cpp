@@ -0,0 +1,13 @@
+#include "pfilterConvolution.h"
+
+pfilterConvolution::pfilterConvolution(const convolutionKernel& userKernel)
+    : pfilter("pthread_convolution", userKernel.getSize()), kernel(userKernel) {
+}
+
+void pfilterConvolution::applyToView(const imageView& input, const imageView& output, int maxValue) {
+    // El motor común de filter recorre la región por filas; los vecinos fuera
+    // de ella (hasta el radio del kernel) salen del halo: píxeles de otros
+    // cuadrantes o el borde repetido
+    convolveView(input, output, kernel.getCoefficients(), kernel.getDivisor(), maxValue,
+                 kernel.getOffset());
+}
@@ -0,0 +1,19 @@
+#ifndef PTHREAD_CONVOLUTION_FILTER_H
+#define PTHREAD_CONVOLUTION_FILTER_H
+
+#include "pfilter.h"
+#include "convolutionKernel.h"
+
+// Kernel NxN del usuario (ver convolutionKernel) repartido en los 4 cuadrantes
+class pfilterConvolution : public pfilter {
+private:
+    convolutionKernel kernel;
+
+public:
+    pfilterConvolution(const convolutionKernel& userKernel);
+
+    // Convolución de una región (el cuadrante de un hilo) de un canal
+    void applyToView(const imageView& input, const imageView& output, int maxValue) override;
+};
+
+#endif
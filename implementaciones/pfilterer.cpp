@@ -4,48 +4,36 @@
 #include "Image.h"
 #include "imagesPGM.h"
 #include "imagesPPM.h"
+#include "imageFactory.h"
 #include "pfilter.h"
 #include "pfilterBlur.h"
 #include "pfilterLaplace.h"
 #include "pfilterSharpen.h"
+#include "pfilterConvolution.h"
 #include "Timer.h"
+#include "simdStencil.h"
 #include <iomanip>
 
-// Función para detectar el tipo de archivo por número mágico
-Image* createImageFromFile(const char* filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: No se puede abrir el archivo " << filename << std::endl;
-        return nullptr;
-    }
-    
-    char magicNumber[3];
-    file >> magicNumber;
-    file.close();
-    
-    if (strcmp(magicNumber, "P2") == 0) {
-        return new imagesPGM();
-    } else if (strcmp(magicNumber, "P3") == 0) {
-        return new imagesPPM();
-    } else {
-        std::cerr << "Error: Formato no soportado. Número mágico: " << magicNumber << std::endl;
-        return nullptr;
-    }
-}
-
 // Función para crear imagen de salida con las mismas características que la entrada
-Image* createOutputImage(Image* input) {
+// (solo cabecera y geometría: el filtro sobrescribe todos los píxeles)
+// Con P5/P6 de 8 bits los píxeles de salida se proyectan sobre outputFile
+// (si no es nullptr): el filtro escribe cada fila en su lugar definitivo de
+// un temporal que al guardar se renombra a outputFile, así que outputFile
+// puede ser el mismo archivo que la entrada proyectada
+Image* createOutputImage(Image* input, const char* outputFile) {
     if (!input) return nullptr;
     
-    if (strcmp(input->getMagicNumber(), "P2") == 0) {
+    if (input->isGrayscale()) {
         imagesPGM* pgmInput = dynamic_cast<imagesPGM*>(input);
         if (pgmInput) {
-            return pgmInput->clone();
+            imagesPGM* mapped = outputFile ? pgmInput->createMappedOutput(outputFile) : nullptr;
+            return mapped ? mapped : pgmInput->createLike();
         }
-    } else if (strcmp(input->getMagicNumber(), "P3") == 0) {
+    } else if (input->isColor()) {
         imagesPPM* ppmInput = dynamic_cast<imagesPPM*>(input);
         if (ppmInput) {
-            return ppmInput->clone();
+            imagesPPM* mapped = outputFile ? ppmInput->createMappedOutput(outputFile) : nullptr;
+            return mapped ? mapped : ppmInput->createLike();
         }
     }
     
@@ -65,19 +53,42 @@ pfilter* createPthreadFilter(const char* filterName) {
     }
 }
 
+// "--f <filtro>" para los filtros incluidos o "--k <kernel>" para un kernel
+// NxN del usuario (archivo o lista de coeficientes, ver convolutionKernel)
+pfilter* createPthreadFilter(const char* filterFlag, const char* filterName) {
+    if (strcmp(filterFlag, "--k") == 0) {
+        convolutionKernel kernel;
+        if (!kernel.load(filterName)) {
+            return nullptr;
+        }
+        return new pfilterConvolution(kernel);
+    }
+    pfilter* filter = createPthreadFilter(filterName);
+    if (!filter) {
+        std::cerr << "Error: Filtro no reconocido: " << filterName << std::endl;
+        std::cerr << "Filtros disponibles: blur, laplace, sharpen" << std::endl;
+    }
+    return filter;
+}
+
 void printUsage(const char* programName) {
-    std::cout << "Uso: " << programName << " <entrada> <salida> --f <filtro>" << std::endl;
+    std::cout << "Uso: " << programName << " <entrada> <salida> (--f <filtro> | --k <kernel>)" << std::endl;
     std::cout << "Ejemplos:" << std::endl;
     std::cout << "  " << programName << " fruit.pgm fruit_blur2.pgm --f blur" << std::endl;
     std::cout << "  " << programName << " damma.pgm damma_laplace.pgm --f laplace" << std::endl;
     std::cout << "  " << programName << " sulfur.pgm sulfur_sharpen.pgm --f sharpen" << std::endl;
+    std::cout << "  " << programName << " fruit.pgm fruit_gauss5.pgm --k gauss5.txt" << std::endl;
     std::cout << std::endl;
     std::cout << "Filtros disponibles con pthreads (4 hilos):" << std::endl;
     std::cout << "  - blur     : Filtro de suavizado paralelo" << std::endl;
     std::cout << "  - laplace  : Filtro Laplaciano paralelo" << std::endl;
     std::cout << "  - sharpen  : Filtro de realce paralelo" << std::endl;
     std::cout << std::endl;
+    std::cout << "Con --k se aplica un kernel NxN propio (N impar), desde un archivo o como" << std::endl;
+    std::cout << "lista de coeficientes por filas; \"divisor N\" y \"offset N\" son opcionales" << std::endl;
+    std::cout << std::endl;
     std::cout << "Nota: La imagen se divide en 4 cuadrantes procesados en paralelo" << std::endl;
+    std::cout << "Con <salida> terminada en .gz la imagen se guarda comprimida con gzip" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -94,8 +105,8 @@ int main(int argc, char* argv[]) {
     const char* filterName = argv[4];
     
     // Verificar formato de argumentos
-    if (strcmp(filterFlag, "--f") != 0) {
-        std::cerr << "Error: Se esperaba '--f' antes del nombre del filtro" << std::endl;
+    if (strcmp(filterFlag, "--f") != 0 && strcmp(filterFlag, "--k") != 0) {
+        std::cerr << "Error: Se esperaba '--f' o '--k' antes del filtro" << std::endl;
         printUsage(argv[0]);
         return 1;
     }
@@ -107,6 +118,13 @@ int main(int argc, char* argv[]) {
     std::cout << "Paralelización: 4 hilos (cuadrantes)" << std::endl;
     std::cout << "===========================================" << std::endl << std::endl;
     
+    // El filtro se crea antes de cargar la imagen: el radio de su kernel
+    // decide el relleno
+    pfilter* filter = createPthreadFilter(filterFlag, filterName);
+    if (!filter) {
+        return 1;
+    }
+    
     timer totalTimer;
     totalTimer.start();
     
@@ -115,15 +133,16 @@ int main(int argc, char* argv[]) {
     timer loadTimer;
     loadTimer.start();
     
-    Image* inputImage = createImageFromFile(inputFile);
+    // Relleno replicado del radio del kernel: los filtros leen los vecinos
+    // del borde sin recortar coordenadas. Las entradas P5/P6 de 8 bits se
+    // usan sin copiar desde la proyección del archivo (entonces sin relleno)
+    imageLoadOptions options;
+    options.halo = filter->getKernelSize() / 2;
+    options.memoryMapped = true;
+    Image* inputImage = imageFactory::load(inputFile, options);
     if (!inputImage) {
-        std::cerr << "Error: No se pudo crear la imagen de entrada" << std::endl;
-        return 1;
-    }
-    
-    if (!inputImage->loadFromFile(inputFile)) {
         std::cerr << "Error: No se pudo cargar " << inputFile << std::endl;
-        delete inputImage;
+        delete filter;
         return 1;
     }
     
@@ -134,23 +153,16 @@ int main(int argc, char* argv[]) {
     
     // Crear filtro pthread
     std::cout << "2. Inicializando filtro pthread..." << std::endl;
-    pfilter* filter = createPthreadFilter(filterName);
-    if (!filter) {
-        std::cerr << "Error: Filtro no reconocido: " << filterName << std::endl;
-        std::cerr << "Filtros disponibles: blur, laplace, sharpen" << std::endl;
-        delete inputImage;
-        return 1;
-    }
-    
     std::cout << "Filtro '" << filter->getName() << "' inicializado correctamente" << std::endl;
     std::cout << "Tamaño de kernel: " << filter->getKernelSize() << "x" << filter->getKernelSize() << std::endl;
+    std::cout << "Instrucciones vectoriales: " << simdStencil::levelName(simdStencil::level()) << std::endl;
     std::cout << "Número de hilos: 4 (división en cuadrantes)" << std::endl << std::endl;
     
     // Crear imagen de salida
     std::cout << "3. Creando imagen de salida..." << std::endl;
-    Image* outputImage = createOutputImage(inputImage);
+    Image* outputImage = createOutputImage(inputImage, outputFile);
     if (!outputImage) {
-        std::cerr << "Error: No se pudo crear la imagen de salida" << std::endl;
+        std::cerr << "Error: No se pudo crear la imagen de salida " << outputFile << std::endl;
         delete inputImage;
         delete filter;
         return 1;
@@ -223,6 +235,9 @@ int main(int argc, char* argv[]) {
     delete outputImage;
     delete filter;
     
+    // Los buffers liberados quedan en el pool para el siguiente trabajo
+    bufferPool::instance().printStatistics();
+    
     std::cout << "\n✓ Procesamiento con pthreads completado exitosamente" << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "imagesPPM.h"
 #include "imagesPGM.h"
 #include "image.h"
+#include "imageFactory.h"
+#include "tiledFormat.h"
 #include <iostream>
 #include <cstring>
 #include <string>
@@ -32,66 +34,64 @@ std::string getFileNameOnly(const char* path) {
     return s.substr(pos + 1);
 }
 
-// Crear objeto imagen según número mágico
-Image* createImageFromFile(const char* filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: No se puede abrir el archivo " << filename << std::endl;
-        return nullptr;
-    }
-    
-    char magicNumber[3];
-    file >> magicNumber;
-    file.close();
-    
-    if (strcmp(magicNumber, "P2") == 0) {
-        return new imagesPGM();
-    } else if (strcmp(magicNumber, "P3") == 0) {
-        return new imagesPPM();
-    } else {
-        std::cerr << "Error: Formato no soportado. Número mágico: " << magicNumber << std::endl;
-        return nullptr;
-    }
-}
-
 // Mostrar ayuda de uso
 void printUsage(const char* programName) {
-    std::cout << "Uso: " << programName << " <archivo_entrada1> [archivo_entrada2] ..." << std::endl;
+    std::cout << "Uso: " << programName << " [--tiled] [--binary | --ascii] <archivo_entrada1> [archivo_entrada2] ..." << std::endl;
     std::cout << "Ejemplos:" << std::endl;
     std::cout << "  " << programName << " lena.ppm" << std::endl;
     std::cout << "  " << programName << " lena.ppm lena2.ppm" << std::endl;
     std::cout << "  " << programName << " imagen.pgm" << std::endl;
     std::cout << std::endl;
     std::cout << "Formatos soportados:" << std::endl;
-    std::cout << "  - PPM (P3): Imágenes a color" << std::endl;
-    std::cout << "  - PGM (P2): Imágenes en escala de grises" << std::endl;
+    std::cout << "  - PPM (P3 ASCII, P6 binario): Imágenes a color" << std::endl;
+    std::cout << "  - PGM (P2 ASCII, P5 binario): Imágenes en escala de grises" << std::endl;
+    std::cout << "  - PNT: caché binaria en mosaicos de cualquiera de las anteriores" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Con --tiled las copias se guardan como caché en mosaicos (copy_<nombre>.pnt)," << std::endl;
+    std::cout << "que se recarga sin analizar texto y permite leer solo una región" << std::endl;
+    std::cout << "Con --binary las copias se guardan en binario (P5/P6) y con --ascii en texto" << std::endl;
+    std::cout << "(P2/P3); por defecto conservan el formato de la entrada" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
+    bool tiledCopies = false;
+    bool binaryCopies = false;
+    bool asciiCopies = false;
+    int firstFile = 1;
+    for (; firstFile < argc && strncmp(argv[firstFile], "--", 2) == 0; firstFile++) {
+        if (strcmp(argv[firstFile], "--tiled") == 0) {
+            tiledCopies = true;
+        } else if (strcmp(argv[firstFile], "--binary") == 0) {
+            binaryCopies = true;
+        } else if (strcmp(argv[firstFile], "--ascii") == 0) {
+            asciiCopies = true;
+        } else {
+            std::cerr << "Error: Opción desconocida " << argv[firstFile] << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (binaryCopies && asciiCopies) {
+        std::cerr << "Error: --binary y --ascii no se pueden usar juntas" << std::endl;
+        return 1;
+    }
+    if (argc <= firstFile) {
         std::cerr << "Error: Se requiere al menos un archivo de entrada" << std::endl;
         printUsage(argv[0]);
         return 1;
     }
     
     std::cout << "=== Procesador de Imágenes PPM/PGM ===" << std::endl;
-    std::cout << "Archivos a procesar: " << (argc - 1) << std::endl << std::endl;
+    std::cout << "Archivos a procesar: " << (argc - firstFile) << std::endl << std::endl;
 
-    for (int i = 1; i < argc; i++) {
+    for (int i = firstFile; i < argc; i++) {
         const char* filename = argv[i];
-        std::cout << "Procesando archivo " << i << ": " << filename << std::endl;
+        std::cout << "Procesando archivo " << (i - firstFile + 1) << ": " << filename << std::endl;
         std::cout << "----------------------------------------" << std::endl;
 
-        Image* image = createImageFromFile(filename);
-        
+        Image* image = imageFactory::load(filename);
         if (!image) {
-            std::cerr << "Error: No se pudo crear la imagen para " << filename << std::endl;
-            continue;
-        }
-
-        if (!image->loadFromFile(filename)) {
             std::cerr << "Error: No se pudo cargar " << filename << std::endl;
-            delete image;
             continue;
         }
         
@@ -102,8 +102,9 @@ int main(int argc, char* argv[]) {
             std::cout << "Extensión de archivo: ." << extension << std::endl;
             
             bool consistent = false;
-            if ((strcmp(extension, "ppm") == 0 && strcmp(image->getMagicNumber(), "P3") == 0) ||
-                (strcmp(extension, "pgm") == 0 && strcmp(image->getMagicNumber(), "P2") == 0)) {
+            if ((strcmp(extension, "ppm") == 0 && image->isColor()) ||
+                (strcmp(extension, "pgm") == 0 && image->isGrayscale()) ||
+                strcmp(extension, "pnt") == 0) {
                 consistent = true;
             }
             
@@ -118,7 +119,7 @@ int main(int argc, char* argv[]) {
         
         std::cout << "\n--- Muestra de píxeles (esquina superior izquierda 3x3) ---" << std::endl;
         
-        if (strcmp(image->getMagicNumber(), "P2") == 0) {
+        if (image->isGrayscale()) {
             imagesPGM* pgmImage = dynamic_cast<imagesPGM*>(image);
             if (pgmImage) {
                 for (int y = 0; y < 3 && y < image->getHeight(); y++) {
@@ -128,7 +129,7 @@ int main(int argc, char* argv[]) {
                     std::cout << std::endl;
                 }
             }
-        } else if (strcmp(image->getMagicNumber(), "P3") == 0) {
+        } else if (image->isColor()) {
             imagesPPM* ppmImage = dynamic_cast<imagesPPM*>(image);
             if (ppmImage) {
                 for (int y = 0; y < 3 && y < image->getHeight(); y++) {
@@ -144,6 +145,14 @@ int main(int argc, char* argv[]) {
         // FIX: Usar solo el nombre del archivo sin la ruta para generar el nombre de salida
         std::string baseName = getFileNameOnly(filename);  // Esta función ya limpia la ruta
         std::string outputFilename = "copy_" + baseName;   // Ahora solo usará el nombre limpio
+        if (tiledCopies && !tiledFormat::isTiledName(outputFilename.c_str())) {
+            outputFilename += ".pnt";
+        }
+        
+        // Conversión entre P2/P3 y P5/P6: solo cambia el número mágico
+        if (binaryCopies || asciiCopies) {
+            image->setBinary(binaryCopies);
+        }
         
         std::cout << "\nGuardando copia como: " << outputFilename << std::endl;
         
@@ -0,0 +1,151 @@
+#include "separableKernel.h"
+#include <cstdlib>
+#include <algorithm>
+
+static int greatestCommonDivisor(int a, int b) {
+    while (b != 0) {
+        int rest = a % b;
+        a = b;
+        b = rest;
+    }
+    return a;
+}
+
+separableKernel::separableKernel(const int* kernel, int kernelSize)
+    : size(kernelSize), separable(false), column(kernelSize, 0), row(kernelSize, 0) {
+    // Fila pivote: la primera con algún coeficiente distinto de cero.
+    // Un kernel nulo se deja en la convolución directa
+    int pivot = -1;
+    for (int i = 0; i < size * size && pivot < 0; i++) {
+        if (kernel[i] != 0) pivot = i / size;
+    }
+    if (pivot < 0 || size < 2) {
+        return;
+    }
+
+    // row = fila pivote dividida por su máximo común divisor. Al no tener
+    // divisores comunes, cualquier fila proporcional a ella es un múltiplo
+    // entero, así que column también queda en enteros
+    const int* pivotRow = kernel + pivot * size;
+    int divisor = 0;
+    for (int j = 0; j < size; j++) {
+        divisor = greatestCommonDivisor(divisor, abs(pivotRow[j]));
+    }
+    int reference = -1;
+    for (int j = 0; j < size; j++) {
+        row[j] = pivotRow[j] / divisor;
+        if (reference < 0 && row[j] != 0) reference = j;
+    }
+
+    for (int i = 0; i < size; i++) {
+        const int* kernelRow = kernel + i * size;
+        if (kernelRow[reference] % row[reference] != 0) {
+            return;
+        }
+        column[i] = kernelRow[reference] / row[reference];
+        for (int j = 0; j < size; j++) {
+            if (kernelRow[j] != column[i] * row[j]) {
+                return;
+            }
+        }
+    }
+    separable = true;
+}
+
+void separableKernel::convolve(const imageView& src, const imageView& dst,
+                               int kernelSum, int maxValue, int offset) const {
+    if (src.sampleBytes == 1) {
+        convolveSamples<uint8_t>(src, dst, kernelSum, maxValue, offset);
+    } else {
+        convolveSamples<uint16_t>(src, dst, kernelSum, maxValue, offset);
+    }
+}
+
+// Pasada horizontal de la fila y de src: out[x] = suma de taps[k] * src(x + k - radius)
+template<typename T>
+static void horizontalPass(const imageView& src, int y, const int* taps, int size, int width, int* out) {
+    int radius = size / 2;
+    int step = src.step;
+    const T* line = src.row<const T>(y);
+    // Columnas cuyos vecinos caen todos en la zona legible; fuera de ellas
+    // las coordenadas se recortan al borde
+    int begin, end;
+    src.interiorColumns(radius, begin, end);
+
+    for (int x = 0; x < begin; x++) {
+        int sum = 0;
+        for (int k = 0; k < size; k++) {
+            sum += line[static_cast<ptrdiff_t>(src.clampX(x + k - radius)) * step] * taps[k];
+        }
+        out[x] = sum;
+    }
+    if (step == 1) {
+        for (int x = begin; x < end; x++) {
+            const T* window = line + x - radius;
+            int sum = 0;
+            for (int k = 0; k < size; k++) {
+                sum += window[k] * taps[k];
+            }
+            out[x] = sum;
+        }
+    } else {
+        for (int x = begin; x < end; x++) {
+            const T* window = line + static_cast<ptrdiff_t>(x - radius) * step;
+            int sum = 0;
+            for (int k = 0; k < size; k++) {
+                sum += window[k * step] * taps[k];
+            }
+            out[x] = sum;
+        }
+    }
+    for (int x = end; x < width; x++) {
+        int sum = 0;
+        for (int k = 0; k < size; k++) {
+            sum += line[static_cast<ptrdiff_t>(src.clampX(x + k - radius)) * step] * taps[k];
+        }
+        out[x] = sum;
+    }
+}
+
+template<typename T>
+void separableKernel::convolveSamples(const imageView& src, const imageView& dst,
+                                      int kernelSum, int maxValue, int offset) const {
+    int radius = size / 2;
+    int width = dst.width;
+    // La pasada horizontal de la fila virtual v (de -radius a
+    // height - 1 + radius; fuera de la zona legible repite el borde) va al
+    // hueco (v + radius) % size del anillo
+    std::vector<int> ring(static_cast<size_t>(size) * width);
+    std::vector<int> sums(width);
+    for (int v = -radius; v < radius; v++) {
+        horizontalPass<T>(src, src.clampY(v), row.data(), size, width,
+                          ring.data() + static_cast<size_t>(v + radius) * width);
+    }
+
+    for (int y = 0; y < dst.height; y++) {
+        int newest = y + radius;
+        horizontalPass<T>(src, src.clampY(newest), row.data(), size, width,
+                          ring.data() + static_cast<size_t>((newest + radius) % size) * width);
+
+        // Pasada vertical sobre las size filas del anillo (de y - radius a y + radius)
+        std::fill(sums.begin(), sums.end(), 0);
+        for (int k = 0; k < size; k++) {
+            const int* partial = ring.data() + static_cast<size_t>((y + k) % size) * width;
+            int weight = column[k];
+            for (int x = 0; x < width; x++) {
+                sums[x] += weight * partial[x];
+            }
+        }
+
+        T* outRow = dst.row<T>(y);
+        for (int x = 0; x < width; x++) {
+            int sum = sums[x];
+            if (kernelSum > 1) {
+                sum /= kernelSum;
+            }
+            sum += offset;
+            outRow[static_cast<ptrdiff_t>(x) * dst.step] =
+                static_cast<T>(sum < 0 ? 0 : (sum > maxValue ? maxValue : sum));
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef SEPARABLE_KERNEL_H
+#define SEPARABLE_KERNEL_H
+
+#include <vector>
+#include "imageView.h"
+
+// Un kernel cuadrado es separable si es el producto exterior de una columna
+// y una fila de enteros: kernel[i][j] = column[i] * row[j] (el gaussiano
+// 3x3 es [1,2,1] x [1,2,1]). Entonces la convolución se hace con una pasada
+// horizontal (row) y otra vertical (column): 2 * size productos por píxel
+// en lugar de size * size, con exactamente la misma suma entera.
+// Las pasadas horizontales se guardan en un anillo de size filas, sin
+// imagen intermedia completa
+class separableKernel {
+private:
+    int size;
+    bool separable;
+    std::vector<int> column;
+    std::vector<int> row;
+
+    template<typename T>
+    void convolveSamples(const imageView& src, const imageView& dst,
+                         int kernelSum, int maxValue, int offset) const;
+
+public:
+    // Factoriza kernel (size * size coeficientes, por filas) si es separable
+    separableKernel(const int* kernel, int size);
+
+    bool isSeparable() const { return separable; }
+    const int* getColumn() const { return column.data(); }
+    const int* getRow() const { return row.data(); }
+
+    // Mismo resultado que la convolución directa (filter::convolveView):
+    // bordes por repetición dentro de la zona legible de src, división por
+    // kernelSum si es mayor que 1, suma de offset y recorte a [0, maxValue]
+    void convolve(const imageView& src, const imageView& dst,
+                  int kernelSum, int maxValue, int offset) const;
+};
+
+#endif
@@ -4,22 +4,12 @@
 #include "filter.h"
 
 class sharpenFilter : public filter {
-private:
-    int* kernel;
-    
-    void initializeKernel();
-    
 public:
     sharpenFilter();
-    ~sharpenFilter();
 
     bool applyToPGM(imagesPGM* input, imagesPGM* output) override;
     bool applyToPPM(imagesPPM* input, imagesPPM* output) override;
-
-private:
-    // Métodos auxiliares para el filtro de realce
-    int applySharpenKernel(imagesPGM* image, int x, int y);
-    RGB applySharpenKernelRGB(imagesPPM* image, int x, int y);
+    void applyToView(const imageView& src, const imageView& dst, int maxValue) override;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,391 @@
+#include "simdStencil.h"
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SIMD_STENCIL_X86 1
+#include <immintrin.h>
+#endif
+
+static simdLevel detectLevel() {
+    simdLevel detected = SIMD_SCALAR;
+#ifdef SIMD_STENCIL_X86
+    // SSE2 forma parte de x86-64; AVX2 y AVX-512BW se consultan con CPUID
+    __builtin_cpu_init();
+    detected = SIMD_SSE2;
+    if (__builtin_cpu_supports("avx2")) detected = SIMD_AVX2;
+    if (__builtin_cpu_supports("avx512bw")) detected = SIMD_AVX512;
+#endif
+    const char* requested = getenv("FILTER_SIMD");
+    if (requested) {
+        simdLevel limit = detected;
+        if (strcmp(requested, "scalar") == 0) limit = SIMD_SCALAR;
+        else if (strcmp(requested, "sse2") == 0) limit = SIMD_SSE2;
+        else if (strcmp(requested, "avx2") == 0) limit = SIMD_AVX2;
+        if (limit < detected) detected = limit;
+    }
+    return detected;
+}
+
+simdLevel simdStencil::level() {
+    static const simdLevel current = detectLevel();
+    return current;
+}
+
+const char* simdStencil::levelName(simdLevel level) {
+    switch (level) {
+        case SIMD_SSE2: return "SSE2";
+        case SIMD_AVX2: return "AVX2";
+        case SIMD_AVX512: return "AVX-512";
+        default: return "escalar";
+    }
+}
+
+// Coeficientes distintos de cero del kernel, con su fila (0 arriba, 2 abajo)
+// y su columna relativa (-1, 0, 1)
+struct stencilTaps {
+    int count;
+    int row[9];
+    int dx[9];
+    short weight[9];
+    int divisor;    // kernelSum si se divide (> 1), 1 si no
+    int shift;      // log2(divisor)
+    bool absolute;
+    int maxValue;
+};
+
+static bool prepareTaps(const int* kernel, int kernelSum, bool absolute, int maxValue, stencilTaps& taps) {
+    taps.count = 0;
+    int magnitude = 0;
+    for (int k = 0; k < 9; k++) {
+        if (kernel[k] == 0) continue;
+        if (kernel[k] > 32767 || kernel[k] < -32767) return false;
+        taps.row[taps.count] = k / 3;
+        taps.dx[taps.count] = k % 3 - 1;
+        taps.weight[taps.count] = static_cast<short>(kernel[k]);
+        taps.count++;
+        magnitude += abs(kernel[k]);
+    }
+    // Cualquier suma parcial está acotada por maxValue * magnitude
+    if (magnitude == 0 || static_cast<long long>(maxValue) * magnitude > 32767) {
+        return false;
+    }
+    taps.divisor = kernelSum > 1 ? kernelSum : 1;
+    taps.shift = 0;
+    while ((1 << taps.shift) < taps.divisor) taps.shift++;
+    if ((1 << taps.shift) != taps.divisor) {
+        return false;
+    }
+    taps.absolute = absolute;
+    taps.maxValue = maxValue;
+    return true;
+}
+
+// Una muestra de salida con aritmética entera normal. columns son las
+// posiciones (ya recortadas) de las columnas x - 1, x y x + 1
+template<typename T>
+static T stencilSample(const T* const* rows, const ptrdiff_t* columns, const stencilTaps& taps) {
+    int sum = 0;
+    for (int k = 0; k < taps.count; k++) {
+        sum += rows[taps.row[k]][columns[taps.dx[k] + 1]] * taps.weight[k];
+    }
+    if (taps.divisor > 1) sum /= taps.divisor;
+    if (taps.absolute) sum = abs(sum);
+    return static_cast<T>(sum < 0 ? 0 : (sum > taps.maxValue ? taps.maxValue : sum));
+}
+
+#ifdef SIMD_STENCIL_X86
+
+// Carga de lanes muestras como enteros de 16 bits y guardado de vuelta
+// (los valores ya están recortados a [0, maxValue])
+static inline __m128i loadSSE2(const uint8_t* p) {
+    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), _mm_setzero_si128());
+}
+static inline __m128i loadSSE2(const uint16_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+static inline void storeSSE2(uint8_t* p, __m128i v) {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(v, v));
+}
+static inline void storeSSE2(uint16_t* p, __m128i v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i loadAVX2(const uint8_t* p) {
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+__attribute__((target("avx2")))
+static inline __m256i loadAVX2(const uint16_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+__attribute__((target("avx2")))
+static inline void storeAVX2(uint8_t* p, __m256i v) {
+    // packus trabaja por mitades de 128 bits: se juntan las dos mitades útiles
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_castsi256_si128(packed));
+}
+__attribute__((target("avx2")))
+static inline void storeAVX2(uint16_t* p, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+__attribute__((target("avx512bw")))
+static inline __m512i loadAVX512(const uint8_t* p) {
+    return _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+}
+__attribute__((target("avx512bw")))
+static inline __m512i loadAVX512(const uint16_t* p) {
+    return _mm512_loadu_si512(p);
+}
+__attribute__((target("avx512bw")))
+static inline void storeAVX512(uint8_t* p, __m512i v) {
+    _mm512_mask_cvtepi16_storeu_epi8(p, static_cast<__mmask32>(0xFFFFFFFFu), v);
+}
+__attribute__((target("avx512bw")))
+static inline void storeAVX512(uint16_t* p, __m512i v) {
+    _mm512_storeu_si512(p, v);
+}
+
+// Núcleos por filas: rows apunta a la columna 0 de las filas y - 1, y, y + 1
+// (contiguas, con la columna -1 y la count legibles). Procesan los bloques
+// completos y devuelven cuántas muestras escribieron; el resto es escalar.
+// La división entre 2^shift redondea hacia cero como la división entera:
+// a las sumas negativas se les suma antes divisor - 1
+template<typename T>
+static int stencilRowSSE2(const T* const* rows, T* out, int count, const stencilTaps& taps) {
+    const int lanes = 8;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i maxValue = _mm_set1_epi16(static_cast<short>(taps.maxValue));
+    const __m128i bias = _mm_set1_epi16(static_cast<short>(taps.divisor - 1));
+    const __m128i shift = _mm_cvtsi32_si128(taps.shift);
+    __m128i weights[9];
+    for (int k = 0; k < taps.count; k++) weights[k] = _mm_set1_epi16(taps.weight[k]);
+
+    int x = 0;
+    for (; x + lanes <= count; x += lanes) {
+        __m128i sum = zero;
+        for (int k = 0; k < taps.count; k++) {
+            __m128i samples = loadSSE2(rows[taps.row[k]] + x + taps.dx[k]);
+            sum = _mm_add_epi16(sum, _mm_mullo_epi16(samples, weights[k]));
+        }
+        if (taps.shift > 0) {
+            sum = _mm_sra_epi16(_mm_add_epi16(sum, _mm_and_si128(_mm_srai_epi16(sum, 15), bias)), shift);
+        }
+        if (taps.absolute) sum = _mm_max_epi16(sum, _mm_sub_epi16(zero, sum));
+        storeSSE2(out + x, _mm_min_epi16(_mm_max_epi16(sum, zero), maxValue));
+    }
+    return x;
+}
+
+template<typename T>
+__attribute__((target("avx2")))
+static int stencilRowAVX2(const T* const* rows, T* out, int count, const stencilTaps& taps) {
+    const int lanes = 16;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i maxValue = _mm256_set1_epi16(static_cast<short>(taps.maxValue));
+    const __m256i bias = _mm256_set1_epi16(static_cast<short>(taps.divisor - 1));
+    const __m128i shift = _mm_cvtsi32_si128(taps.shift);
+    __m256i weights[9];
+    for (int k = 0; k < taps.count; k++) weights[k] = _mm256_set1_epi16(taps.weight[k]);
+
+    int x = 0;
+    for (; x + lanes <= count; x += lanes) {
+        __m256i sum = zero;
+        for (int k = 0; k < taps.count; k++) {
+            __m256i samples = loadAVX2(rows[taps.row[k]] + x + taps.dx[k]);
+            sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(samples, weights[k]));
+        }
+        if (taps.shift > 0) {
+            sum = _mm256_sra_epi16(_mm256_add_epi16(sum, _mm256_and_si256(_mm256_srai_epi16(sum, 15), bias)), shift);
+        }
+        if (taps.absolute) sum = _mm256_abs_epi16(sum);
+        storeAVX2(out + x, _mm256_min_epi16(_mm256_max_epi16(sum, zero), maxValue));
+    }
+    return x;
+}
+
+template<typename T>
+__attribute__((target("avx512bw")))
+static int stencilRowAVX512(const T* const* rows, T* out, int count, const stencilTaps& taps) {
+    const int lanes = 32;
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i maxValue = _mm512_set1_epi16(static_cast<short>(taps.maxValue));
+    const __m512i bias = _mm512_set1_epi16(static_cast<short>(taps.divisor - 1));
+    const __m128i shift = _mm_cvtsi32_si128(taps.shift);
+    __m512i weights[9];
+    for (int k = 0; k < taps.count; k++) weights[k] = _mm512_set1_epi16(taps.weight[k]);
+
+    int x = 0;
+    for (; x + lanes <= count; x += lanes) {
+        __m512i sum = zero;
+        for (int k = 0; k < taps.count; k++) {
+            __m512i samples = loadAVX512(rows[taps.row[k]] + x + taps.dx[k]);
+            sum = _mm512_add_epi16(sum, _mm512_mullo_epi16(samples, weights[k]));
+        }
+        if (taps.shift > 0) {
+            sum = _mm512_sra_epi16(_mm512_add_epi16(sum, _mm512_and_si512(_mm512_srai_epi16(sum, 15), bias)), shift);
+        }
+        if (taps.absolute) sum = _mm512_abs_epi16(sum);
+        storeAVX512(out + x, _mm512_min_epi16(_mm512_max_epi16(sum, zero), maxValue));
+    }
+    return x;
+}
+
+template<typename T>
+static int stencilRow(simdLevel level, const T* const* rows, T* out, int count, const stencilTaps& taps) {
+    switch (level) {
+        case SIMD_AVX512: return stencilRowAVX512<T>(rows, out, count, taps);
+        case SIMD_AVX2: return stencilRowAVX2<T>(rows, out, count, taps);
+        case SIMD_SSE2: return stencilRowSSE2<T>(rows, out, count, taps);
+        default: return 0;
+    }
+}
+
+#else
+
+template<typename T>
+static int stencilRow(simdLevel, const T* const*, T*, int, const stencilTaps&) {
+    return 0;
+}
+
+#endif
+
+// Fila de salida contigua a partir de filas contiguas con una columna
+// legible a cada lado: bloques vectoriales y el resto escalar
+template<typename T>
+static void stencilRun(simdLevel level, const T* const* rows, T* out, int count, const stencilTaps& taps) {
+    int x = stencilRow<T>(level, rows, out, count, taps);
+    for (; x < count; x++) {
+        ptrdiff_t columns[3] = { x - 1, x, x + 1 };
+        out[x] = stencilSample<T>(rows, columns, taps);
+    }
+}
+
+template<typename T>
+static void stencilView(simdLevel level, const imageView& src, const imageView& dst, const stencilTaps& taps) {
+    int width = dst.width;
+    const T* rows[3];
+
+    if (src.step == 1 && dst.step == 1) {
+        // Filas planas: los núcleos leen directamente de la imagen. Solo las
+        // columnas sin vecino legible (sin halo) se recortan aparte
+        int begin, end;
+        src.interiorColumns(1, begin, end);
+        for (int y = 0; y < dst.height; y++) {
+            for (int k = 0; k < 3; k++) {
+                rows[k] = src.row<const T>(src.clampY(y + k - 1));
+            }
+            T* outRow = dst.row<T>(y);
+            for (int x = 0; x < begin; x++) {
+                ptrdiff_t columns[3] = { src.clampX(x - 1), x, src.clampX(x + 1) };
+                outRow[x] = stencilSample<T>(rows, columns, taps);
+            }
+            const T* shifted[3] = { rows[0] + begin, rows[1] + begin, rows[2] + begin };
+            stencilRun<T>(level, shifted, outRow + begin, end - begin, taps);
+            for (int x = end; x < width; x++) {
+                ptrdiff_t columns[3] = { src.clampX(x - 1), x, src.clampX(x + 1) };
+                outRow[x] = stencilSample<T>(rows, columns, taps);
+            }
+        }
+        return;
+    }
+
+    // Canal intercalado (paso 3): cada fila se separa una vez en un anillo de
+    // tres filas contiguas con el borde replicado, y la salida se reparte
+    // después con su paso
+    int padded = width + 2;
+    std::vector<T> ring(3 * static_cast<size_t>(padded));
+    std::vector<T> outRow(width);
+    for (int v = -1; v < dst.height + 1; v++) {
+        T* slot = ring.data() + static_cast<size_t>((v + 1) % 3) * padded;
+        const T* line = src.row<const T>(src.clampY(v));
+        const T* sample = line;
+        for (int i = 0; i < width; i++, sample += src.step) {
+            slot[i + 1] = *sample;
+        }
+        slot[0] = line[static_cast<ptrdiff_t>(src.clampX(-1)) * src.step];
+        slot[width + 1] = line[static_cast<ptrdiff_t>(src.clampX(width)) * src.step];
+
+        int y = v - 1;
+        if (y < 0) continue;
+        for (int k = 0; k < 3; k++) {
+            rows[k] = ring.data() + static_cast<size_t>((y + k) % 3) * padded + 1;
+        }
+        stencilRun<T>(level, rows, outRow.data(), width, taps);
+        T* out = dst.row<T>(y);
+        for (int x = 0; x < width; x++, out += dst.step) {
+            *out = outRow[x];
+        }
+    }
+}
+
+bool simdStencil::convolve3x3(const imageView& src, const imageView& dst,
+                              const int* kernel, int kernelSum, bool absolute, int maxValue) {
+    simdLevel current = level();
+    stencilTaps taps;
+    if (current == SIMD_SCALAR || !prepareTaps(kernel, kernelSum, absolute, maxValue, taps)) {
+        return false;
+    }
+    if (src.sampleBytes == 1) {
+        stencilView<uint8_t>(current, src, dst, taps);
+    } else {
+        stencilView<uint16_t>(current, src, dst, taps);
+    }
+    return true;
+}
+
+// Acumulación por filas en enteros de 32 bits (8 o 16 por instrucción).
+// SSE2 no multiplica enteros de 32 bits, así que ese nivel usa el bucle escalar
+#ifdef SIMD_STENCIL_X86
+
+__attribute__((target("avx2")))
+static int accumulateRowAVX2(const int* line, int weight, int* sums, int count) {
+    const int lanes = 8;
+    const __m256i weights = _mm256_set1_epi32(weight);
+    int i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + i));
+        __m256i sum = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sums + i));
+        sum = _mm256_add_epi32(sum, _mm256_mullo_epi32(samples, weights));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums + i), sum);
+    }
+    return i;
+}
+
+__attribute__((target("avx512bw")))
+static int accumulateRowAVX512(const int* line, int weight, int* sums, int count) {
+    const int lanes = 16;
+    const __m512i weights = _mm512_set1_epi32(weight);
+    int i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        __m512i samples = _mm512_loadu_si512(line + i);
+        __m512i sum = _mm512_loadu_si512(sums + i);
+        _mm512_storeu_si512(sums + i, _mm512_add_epi32(sum, _mm512_mullo_epi32(samples, weights)));
+    }
+    return i;
+}
+
+static int accumulateRowVector(simdLevel level, const int* line, int weight, int* sums, int count) {
+    switch (level) {
+        case SIMD_AVX512: return accumulateRowAVX512(line, weight, sums, count);
+        case SIMD_AVX2: return accumulateRowAVX2(line, weight, sums, count);
+        default: return 0;
+    }
+}
+
+#else
+
+static int accumulateRowVector(simdLevel, const int*, int, int*, int) {
+    return 0;
+}
+
+#endif
+
+void simdStencil::accumulateRow(const int* line, int weight, int* sums, int count) {
+    int i = accumulateRowVector(level(), line, weight, sums, count);
+    for (; i < count; i++) {
+        sums[i] += weight * line[i];
+    }
+}
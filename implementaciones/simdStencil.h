@@ -0,0 +1,40 @@
+#ifndef SIMD_STENCIL_H
+#define SIMD_STENCIL_H
+
+#include "imageView.h"
+
+// Instrucciones vectoriales disponibles, de menor a mayor
+enum simdLevel {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_AVX512
+};
+
+// Convolución 3x3 por filas con SSE2, AVX2 o AVX-512BW, elegida en tiempo
+// de ejecución según CPUID. Cada instrucción procesa 8, 16 o 32 muestras en
+// enteros de 16 bits, así que solo se usa cuando ninguna suma parcial puede
+// desbordarlos (maxValue * suma de |coeficientes| <= 32767) y kernelSum es
+// 1 o potencia de dos (la división es un desplazamiento). En otro caso
+// convolve3x3 devuelve false y el llamador sigue con su versión escalar.
+// El resultado es idéntico bit a bit al de la convolución escalar.
+// La variable de entorno FILTER_SIMD (scalar, sse2, avx2, avx512) limita el
+// nivel, para comparar con la versión escalar
+class simdStencil {
+public:
+    // Nivel en uso: el mayor que admite la CPU, limitado por FILTER_SIMD
+    static simdLevel level();
+    static const char* levelName(simdLevel level);
+
+    // Mismo contrato que filter::convolveView con un kernel 3x3: bordes por
+    // repetición dentro de la zona legible de src, vistas planas o intercaladas
+    static bool convolve3x3(const imageView& src, const imageView& dst,
+                            const int* kernel, int kernelSum, bool absolute, int maxValue);
+
+    // sums[i] += weight * line[i] para count enteros, con AVX2 o AVX-512 si
+    // están disponibles: una pasada de un coeficiente en la convolución por
+    // filas de los kernels grandes (ver filter::convolveView)
+    static void accumulateRow(const int* line, int weight, int* sums, int count);
+};
+
+#endif
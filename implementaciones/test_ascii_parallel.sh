@@ -0,0 +1,67 @@
+#!/bin/bash
+
+# Compara el análisis ASCII paralelo (OpenMP) con el secuencial: con 1 hilo
+# y con varios, opfilterer debe aceptar y rechazar los mismos archivos P2,
+# con el mismo mensaje de error y las mismas salidas.
+# Uso: ./test_ascii_parallel.sh [ruta_de_opfilterer]
+
+OPFILTERER=${1:-./opfilterer}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if [ ! -x "$OPFILTERER" ]; then
+    echo "Error: No se encuentra $OPFILTERER (compilar con benchmark_all_versions.sh)"
+    exit 1
+fi
+
+# P2 de 1000x700 (unos 2 MB de cuerpo, por encima del umbral del análisis
+# paralelo). Con basura, 600 KB de "x " separan las primeras 300000 muestras
+# del resto: con 2 o más hilos hay tramos sin ningún número y tramos cuya
+# última muestra va seguida de basura
+make_image() {
+    awk -v garbage="$2" 'BEGIN {
+        print "P2"; print "1000 700"; print "255"
+        for (i = 0; i < 700000; i++) {
+            if (garbage && i == 300000) for (k = 0; k < 300000; k++) printf "x "
+            printf "%d ", (i * 7) % 256
+            if (i % 1000 == 999) printf "\n"
+        }
+    }' > "$1"
+}
+
+make_image "$WORK/valid.pgm" 0
+make_image "$WORK/garbage.pgm" 1
+
+failures=0
+
+# Código de salida y mensajes de error de una ejecución
+run() {
+    OMP_NUM_THREADS=$1 "$OPFILTERER" "$2" "$WORK/out_$1.pgm" > /dev/null 2> "$WORK/err_$1.txt"
+    echo "código $?: $(grep Error "$WORK/err_$1.txt")"
+}
+
+for image in valid garbage; do
+    expected=$(run 1 "$WORK/$image.pgm")
+    for threads in 2 4 8; do
+        result=$(run $threads "$WORK/$image.pgm")
+        if [ "$result" != "$expected" ]; then
+            echo "✗ $image.pgm con $threads hilos: '$result' (1 hilo: '$expected')"
+            failures=$((failures + 1))
+            continue
+        fi
+        for filter in blur laplace sharpen; do
+            if [ -f "$WORK/out_1_$filter.pgm" ] &&
+               ! cmp -s "$WORK/out_1_$filter.pgm" "$WORK/out_${threads}_$filter.pgm"; then
+                echo "✗ $image.pgm con $threads hilos: $filter distinto del de 1 hilo"
+                failures=$((failures + 1))
+            fi
+        done
+    done
+    echo "$image.pgm: $expected"
+done
+
+if [ $failures -ne 0 ]; then
+    echo "✗ $failures diferencias entre el análisis secuencial y el paralelo"
+    exit 1
+fi
+echo "✓ El análisis paralelo coincide con el secuencial"
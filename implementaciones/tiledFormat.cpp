@@ -0,0 +1,205 @@
+#include "tiledFormat.h"
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+bool tiledFormat::isTiledMagic(const char* magic) {
+    return strcmp(magic, magicNumber()) == 0;
+}
+
+bool tiledFormat::isTiledName(const char* filename) {
+    size_t length = strlen(filename);
+    if (length > 3 && strcmp(filename + length - 3, ".gz") == 0) {
+        length -= 3;
+    }
+    return length > 4 && strncmp(filename + length - 4, ".pnt", 4) == 0;
+}
+
+// Bytes de un mosaico de w x h píxeles
+static size_t tileBytes(int w, int h, int channelCount, int sampleBytes) {
+    return static_cast<size_t>(w) * h * channelCount * sampleBytes;
+}
+
+template<typename T>
+static void packTile(const imageView* channels, int channelCount, int x0, int y0, int w, int h,
+                     unsigned char* out) {
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            for (int c = 0; c < channelCount; c++) {
+                T value = channels[c].row<T>(y0 + y)[static_cast<ptrdiff_t>(x0 + x) * channels[c].step];
+                *out++ = static_cast<unsigned char>(value & 0xff);
+                if (sizeof(T) == 2) *out++ = static_cast<unsigned char>(value >> 8);
+            }
+        }
+    }
+}
+
+bool tiledFormat::write(std::ostream& file, const imageView* channels, int channelCount, int tileSize) {
+    int width = channels[0].width;
+    int height = channels[0].height;
+    int sampleBytes = channels[0].sampleBytes;
+    int tilesX = (width + tileSize - 1) / tileSize;
+    int tilesY = (height + tileSize - 1) / tileSize;
+
+    file << tileSize << '\n';
+
+    // Índice: los mosaicos no se comprimen, así que los desplazamientos se
+    // conocen antes de escribirlos
+    size_t tileCount = static_cast<size_t>(tilesX) * tilesY;
+    std::vector<unsigned char> index((tileCount + 1) * 8);
+    uint64_t offset = 0;
+    for (size_t t = 0; t <= tileCount; t++) {
+        for (int b = 0; b < 8; b++) {
+            index[t * 8 + b] = static_cast<unsigned char>((offset >> (8 * b)) & 0xff);
+        }
+        if (t < tileCount) {
+            int tx = static_cast<int>(t % tilesX);
+            int ty = static_cast<int>(t / tilesX);
+            int w = std::min(tileSize, width - tx * tileSize);
+            int h = std::min(tileSize, height - ty * tileSize);
+            offset += tileBytes(w, h, channelCount, sampleBytes);
+        }
+    }
+    if (!file.write(reinterpret_cast<const char*>(index.data()), index.size())) {
+        return false;
+    }
+
+    std::vector<unsigned char> tile(tileBytes(tileSize, tileSize, channelCount, sampleBytes));
+    for (int ty = 0; ty < tilesY; ty++) {
+        for (int tx = 0; tx < tilesX; tx++) {
+            int x0 = tx * tileSize;
+            int y0 = ty * tileSize;
+            int w = std::min(tileSize, width - x0);
+            int h = std::min(tileSize, height - y0);
+            if (sampleBytes == 1) {
+                packTile<uint8_t>(channels, channelCount, x0, y0, w, h, tile.data());
+            } else {
+                packTile<uint16_t>(channels, channelCount, x0, y0, w, h, tile.data());
+            }
+            if (!file.write(reinterpret_cast<const char*>(tile.data()), tileBytes(w, h, channelCount, sampleBytes))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Copia de un mosaico (origen (x0, y0), w columnas) las muestras que corresponden
+// a las columnas [i0, i1) y filas [j0, j1) de la vista, cuya posición (i, j)
+// es el píxel (clamp(x + i), clamp(y + j)) de la imagen
+template<typename T>
+static bool unpackTile(const unsigned char* tile, int x0, int y0, int w,
+                       const imageView* channels, int channelCount, int maxValue,
+                       int x, int y, int width, int height, int i0, int i1, int j0, int j1) {
+    for (int j = j0; j < j1; j++) {
+        int sy = std::min(std::max(y + j, 0), height - 1) - y0;
+        for (int i = i0; i < i1; i++) {
+            int sx = std::min(std::max(x + i, 0), width - 1) - x0;
+            const unsigned char* in = tile + (static_cast<size_t>(sy) * w + sx) * channelCount * sizeof(T);
+            for (int c = 0; c < channelCount; c++) {
+                int value = sizeof(T) == 1 ? in[0] : (in[0] | (in[1] << 8));
+                in += sizeof(T);
+                if (value > maxValue) {
+                    std::cerr << "Error: Valor de píxel fuera de rango: " << value << std::endl;
+                    return false;
+                }
+                channels[c].row<T>(j)[static_cast<ptrdiff_t>(i) * channels[c].step] = static_cast<T>(value);
+            }
+        }
+    }
+    return true;
+}
+
+// Primera posición p de [first, last) con clamp(origin + p) >= limit
+static int firstAtLeast(int origin, int first, int last, int limit) {
+    int p = limit - origin;
+    if (limit <= 0) p = first;
+    return std::min(std::max(p, first), last);
+}
+
+bool tiledFormat::readRegion(std::istream& file, int width, int height, const imageView* channels,
+                             int channelCount, int maxValue, int x, int y) {
+    int tileSize = 0;
+    file >> tileSize;
+    file.ignore();
+    if (!file || tileSize <= 0) {
+        std::cerr << "Error: Tamaño de mosaico inválido" << std::endl;
+        return false;
+    }
+    int sampleBytes = channels[0].sampleBytes;
+    int tilesX = (width + tileSize - 1) / tileSize;
+    int tilesY = (height + tileSize - 1) / tileSize;
+    size_t entries = static_cast<size_t>(tilesX) * tilesY + 1;
+
+    std::vector<unsigned char> raw(entries * 8);
+    if (!file.read(reinterpret_cast<char*>(raw.data()), raw.size())) {
+        std::cerr << "Error: Índice de mosaicos incompleto" << std::endl;
+        return false;
+    }
+    std::vector<uint64_t> offsets(entries);
+    for (size_t e = 0; e < entries; e++) {
+        uint64_t value = 0;
+        for (int b = 7; b >= 0; b--) value = (value << 8) | raw[e * 8 + b];
+        offsets[e] = value;
+    }
+    std::streamoff dataStart = file.tellg();
+
+    // Zona de la vista que hay que llenar (región + halo) y píxeles de la
+    // imagen que le corresponden (recortados al borde)
+    int iBegin = -channels[0].haloLeft;
+    int iEnd = channels[0].width + channels[0].haloRight;
+    int jBegin = -channels[0].haloTop;
+    int jEnd = channels[0].height + channels[0].haloBottom;
+    int srcX0 = std::min(std::max(x + iBegin, 0), width - 1);
+    int srcX1 = std::min(std::max(x + iEnd - 1, 0), width - 1);
+    int srcY0 = std::min(std::max(y + jBegin, 0), height - 1);
+    int srcY1 = std::min(std::max(y + jEnd - 1, 0), height - 1);
+
+    std::vector<unsigned char> tile(tileBytes(tileSize, tileSize, channelCount, sampleBytes));
+    for (int ty = srcY0 / tileSize; ty <= srcY1 / tileSize; ty++) {
+        for (int tx = srcX0 / tileSize; tx <= srcX1 / tileSize; tx++) {
+            int x0 = tx * tileSize;
+            int y0 = ty * tileSize;
+            int w = std::min(tileSize, width - x0);
+            int h = std::min(tileSize, height - y0);
+            size_t t = static_cast<size_t>(ty) * tilesX + tx;
+            size_t bytes = tileBytes(w, h, channelCount, sampleBytes);
+            if (offsets[t + 1] < offsets[t] || offsets[t + 1] - offsets[t] != bytes) {
+                std::cerr << "Error: Índice de mosaicos inválido" << std::endl;
+                return false;
+            }
+            // Los mosaicos de la región se leen en el orden del archivo, así
+            // que solo hay saltos hacia adelante. Si el flujo no admite
+            // desplazarse (gzip) se descartan los bytes intermedios
+            std::streamoff target = dataStart + static_cast<std::streamoff>(offsets[t]);
+            if (!file.seekg(target)) {
+                file.clear();
+                std::streamoff position = file.tellg();
+                if (position < 0 || position > target ||
+                    !file.ignore(static_cast<std::streamsize>(target - position))) {
+                    std::cerr << "Error: No se puede saltar al mosaico (" << tx << ", " << ty << ")" << std::endl;
+                    return false;
+                }
+            }
+            if (!file.read(reinterpret_cast<char*>(tile.data()), bytes)) {
+                std::cerr << "Error: No se pudieron leer todos los píxeles" << std::endl;
+                return false;
+            }
+
+            int i0 = firstAtLeast(x, iBegin, iEnd, x0);
+            int i1 = firstAtLeast(x, iBegin, iEnd, x0 + w);
+            int j0 = firstAtLeast(y, jBegin, jEnd, y0);
+            int j1 = firstAtLeast(y, jBegin, jEnd, y0 + h);
+            if (tx == tilesX - 1) i1 = iEnd;
+            if (ty == tilesY - 1) j1 = jEnd;
+            bool ok = sampleBytes == 1
+                ? unpackTile<uint8_t>(tile.data(), x0, y0, w, channels, channelCount, maxValue, x, y, width, height, i0, i1, j0, j1)
+                : unpackTile<uint16_t>(tile.data(), x0, y0, w, channels, channelCount, maxValue, x, y, width, height, i0, i1, j0, j1);
+            if (!ok) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
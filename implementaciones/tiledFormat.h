@@ -0,0 +1,43 @@
+#ifndef TILED_FORMAT_H
+#define TILED_FORMAT_H
+
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include "imageView.h"
+
+// Caché binaria en mosaicos para recargar imágenes grandes sin volver a
+// analizar el texto. El archivo (.pnt) es:
+//   "PT\n" + cabecera PNM original (número mágico, comentarios, dimensiones,
+//   maxValue) + lado del mosaico en texto ("256\n"), después un índice de
+//   tileCount + 1 desplazamientos uint64 little-endian (relativos al inicio
+//   de los datos; el último marca el final) y los mosaicos uno tras otro.
+// Los mosaicos van por filas de mosaicos; cada uno guarda sus filas con las
+// muestras intercaladas en 1 byte o 2 bytes little-endian (según maxValue).
+// Los del borde derecho e inferior son más pequeños.
+// Con el índice se puede leer cualquier mosaico, o una región con su halo,
+// sin recorrer el resto del archivo
+class tiledFormat {
+public:
+    static const int DEFAULT_TILE_SIZE = 256;
+
+    // "PT", leído en lugar del número mágico antes de la cabecera PNM
+    static bool isTiledMagic(const char* magic);
+    static const char* magicNumber() { return "PT"; }
+    // Nombres ".pnt" (o ".pnt.gz") se guardan en este formato
+    static bool isTiledName(const char* filename);
+
+    // Tras la cabecera PNM ya escrita: lado del mosaico, índice y mosaicos
+    static bool write(std::ostream& file, const imageView* channels, int channelCount, int tileSize);
+
+    // Tras la cabecera PNM ya leída de una imagen de width x height: lee la
+    // región de la vista (channels[0].width x channels[0].height a partir de
+    // (x, y)) y también su halo. Lo que queda fuera de la imagen repite el
+    // borde, así que el halo queda listo para los filtros. Solo se leen los
+    // mosaicos que tocan la región; si el flujo no admite desplazamientos
+    // (gzip) los demás se descomprimen y se descartan
+    static bool readRegion(std::istream& file, int width, int height, const imageView* channels,
+                           int channelCount, int maxValue, int x, int y);
+};
+
+#endif